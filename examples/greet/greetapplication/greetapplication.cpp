@@ -24,7 +24,8 @@
 #include "greetapplication.h"
 
 GreetApplication::GreetApplication(Builder *builder)
-    : _builder(builder)
+    : _builder(builder),
+      _greeter(builder->handle<Greeter>())
 {
 }
 
@@ -33,7 +34,6 @@ int GreetApplication::main(int argc, char **argv)
     Q_UNUSED(argc);
     Q_UNUSED(argv);
 
-    QSharedPointer<Greeter> greeter = _builder->get<Greeter>();
-    greeter->greet();
+    _greeter.get()->greet();
     return 0;
 }
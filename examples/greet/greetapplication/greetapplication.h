@@ -27,6 +27,7 @@
 #include <builder.h>
 #include <greeter.h>
 #include <reflectable.h>
+#include <servicehandle.h>
 
 class GreetApplication : public QObject, public Application, public Reflectable<GreetApplication>
 {
@@ -39,4 +40,5 @@ public:
 
 private:
     Builder *_builder;
+    ServiceHandle<Greeter> _greeter;
 };
@@ -0,0 +1,108 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: arena.cpp
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+
+#include "arena.h"
+
+#include <QtGlobal>
+
+Arena::Arena(int blockSize) :
+    _next(nullptr),
+    _end(nullptr),
+    _blockSize(size_t(blockSize)),
+    _destructors(nullptr)
+{
+} // Arena::Arena(int blockSize)
+
+Arena::~Arena()
+{
+    // Destroy objects newest-first, so that objects created later, which may
+    // refer to earlier ones, go first
+    for (Destructor *destructor = _destructors; destructor; destructor = destructor->next)
+        destructor->destroy(destructor->object);
+
+    for (const QPair<char *, size_t> &block : _blocks)
+        ::operator delete(block.first);
+} // Arena::~Arena()
+
+void *Arena::allocate(size_t size, size_t alignment)
+{
+    QMutexLocker lock(&_mutex);
+    Q_UNUSED(lock);
+
+    return allocateLocked(size, alignment);
+} // void *Arena::allocate(size_t size, size_t alignment)
+
+size_t Arena::reserved() const
+{
+    QMutexLocker lock(&_mutex);
+    Q_UNUSED(lock);
+
+    size_t reserved = 0;
+    for (const QPair<char *, size_t> &block : _blocks)
+        reserved += block.second;
+
+    return reserved;
+} // size_t Arena::reserved() const
+
+void *Arena::allocateLocked(size_t size, size_t alignment)
+{
+    // Round the next free byte up to the requested alignment
+    quintptr next = (quintptr(_next) + alignment - 1) & ~quintptr(alignment - 1);
+    if (_next && next + size <= quintptr(_end))
+    {
+        _next = reinterpret_cast<char *>(next + size);
+        return reinterpret_cast<void *>(next);
+    }
+
+    // Start a new block. Allocations too large for a block get one of their
+    // own, and the current block stays in use.
+    size_t blockSize = qMax(_blockSize, size + alignment);
+    char *block = static_cast<char *>(::operator new(blockSize));
+    _blocks.append(qMakePair(block, blockSize));
+
+    next = (quintptr(block) + alignment - 1) & ~quintptr(alignment - 1);
+    if (blockSize == _blockSize)
+    {
+        _next = reinterpret_cast<char *>(next + size);
+        _end = block + blockSize;
+    }
+
+    return reinterpret_cast<void *>(next);
+} // void *Arena::allocateLocked(size_t size, size_t alignment)
+
+void Arena::addDestructor(void (*destroy)(void *), void *object)
+{
+    QMutexLocker lock(&_mutex);
+    Q_UNUSED(lock);
+
+    Destructor *destructor = static_cast<Destructor *>(allocateLocked(sizeof(Destructor), alignof(Destructor)));
+    destructor->destroy = destroy;
+    destructor->object = object;
+    destructor->next = _destructors;
+    _destructors = destructor;
+} // void Arena::addDestructor(void (*destroy)(void *), void *object)
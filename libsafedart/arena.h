@@ -0,0 +1,198 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: arena.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QPair>
+
+#include <new>
+#include <utility>
+
+/*!
+ * \brief A region of memory from which objects are allocated by bumping a
+ * pointer, and which is freed all at once.
+ *
+ * Allocating from an Arena is much cheaper than allocating from the heap, and
+ * objects allocated together sit next to each other in memory. Objects are
+ * never freed individually; instead, when the Arena is destroyed, every object
+ * created through create() is destroyed in the reverse order of creation, and
+ * the memory is released in a handful of large blocks.
+ *
+ * Builder uses an Arena for each scope (see Builder::createScope()), so that
+ * everything a short-lived scope creates is torn down together.
+ *
+ * \note Arena is thread-safe.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+class Arena
+{
+public:
+    /*!
+     * \brief The size of the blocks in which memory is reserved, unless
+     * otherwise specified.
+     */
+    static const int DefaultBlockSize = 4096;
+
+    /*!
+     * \brief Creates an empty Arena.
+     *
+     * No memory is reserved until the first allocation.
+     *
+     * \param blockSize The size of the blocks in which memory is reserved.
+     */
+    explicit Arena(int blockSize = DefaultBlockSize);
+
+    /*!
+     * \brief Destroys every object created in the Arena, in reverse order of
+     * creation, and releases its memory.
+     */
+    ~Arena();
+
+    /*!
+     * \brief Allocates uninitialized memory from the Arena.
+     *
+     * \param size The number of bytes to allocate.
+     * \param alignment The alignment of the memory; must be a power of two.
+     *
+     * \return A pointer to the memory, which remains valid until the Arena is
+     * destroyed.
+     */
+    void *allocate(size_t size, size_t alignment);
+
+    /*!
+     * \brief Creates an object in the Arena.
+     *
+     * The object is destroyed when the Arena is destroyed, and must not be
+     * deleted by any other means.
+     *
+     * \param arguments The arguments to pass to T's constructor.
+     *
+     * \return A pointer to the new object.
+     */
+    template<typename T, typename... Arguments>
+    T *create(Arguments &&...arguments);
+
+    /*!
+     * \brief Gets the number of bytes reserved by the Arena.
+     *
+     * \return The total size of the Arena's blocks.
+     */
+    size_t reserved() const;
+
+private:
+    Q_DISABLE_COPY(Arena)
+
+    /*!
+     * \brief A record of an object which must be destroyed along with the
+     * Arena. Records are themselves allocated from the Arena, and form a
+     * list from the most recently created object to the first.
+     */
+    struct Destructor
+    {
+        /*!
+         * \brief Destroys \c object.
+         */
+        void (*destroy)(void *object);
+
+        /*!
+         * \brief The object to destroy.
+         */
+        void *object;
+
+        /*!
+         * \brief The record of the previously-created object, if any.
+         */
+        Destructor *next;
+    };
+
+    /*!
+     * \brief Destroys an object of type T.
+     *
+     * \param object The object to destroy.
+     */
+    template<typename T>
+    static void destroy(void *object)
+    {
+        static_cast<T *>(object)->~T();
+    }
+
+    /*!
+     * \brief Allocates memory while \c _mutex is already held.
+     *
+     * \see allocate()
+     */
+    void *allocateLocked(size_t size, size_t alignment);
+
+    /*!
+     * \brief Records that an object must be destroyed along with the Arena.
+     *
+     * \param destroy The function which destroys the object.
+     * \param object The object to destroy.
+     */
+    void addDestructor(void (*destroy)(void *), void *object);
+
+    /*!
+     * \brief A mutex which guards all other members.
+     */
+    mutable QMutex _mutex;
+
+    /*!
+     * \brief The blocks of memory reserved by the Arena, and their sizes.
+     */
+    QList<QPair<char *, size_t>> _blocks;
+
+    /*!
+     * \brief The next free byte in the current block.
+     */
+    char *_next;
+
+    /*!
+     * \brief The end of the current block.
+     */
+    char *_end;
+
+    /*!
+     * \brief The size of the blocks in which memory is reserved.
+     */
+    size_t _blockSize;
+
+    /*!
+     * \brief The record of the most recently created object, if any.
+     */
+    Destructor *_destructors;
+};
+
+template<typename T, typename... Arguments>
+T *Arena::create(Arguments &&...arguments)
+{
+    T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Arguments>(arguments)...);
+    addDestructor(&Arena::destroy<T>, object);
+    return object;
+}
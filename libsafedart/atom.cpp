@@ -0,0 +1,109 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: atom.cpp
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+
+#include "atom.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+
+const Atom::Data Atom::NullData = { QByteArray(), QString(), qHash(QByteArray()), Atom::wideHash(nullptr, 0) };
+
+Atom::Atom(const char *name) :
+    _data(intern(name, int(qstrlen(name))))
+{
+} // Atom::Atom(const char *name)
+
+Atom::Atom(const char *name, int size) :
+    _data(intern(name, size))
+{
+} // Atom::Atom(const char *name, int size)
+
+Atom::Atom(const QByteArray &name) :
+    _data(intern(name.constData(), name.size()))
+{
+} // Atom::Atom(const QByteArray &name)
+
+Atom::Atom(const QString &name) :
+    _data(nullptr)
+{
+    QByteArray utf8 = name.toUtf8();
+    _data = intern(utf8.constData(), utf8.size());
+} // Atom::Atom(const QString &name)
+
+const Atom::Data *Atom::intern(const char *name, int size)
+{
+    // The table is created on first use, so that names may be interned while
+    // other globals are being initialized. Neither it nor its entries are ever
+    // destroyed, and each key shares its data with its entry.
+    static QHash<QByteArray, const Data *> &table = *new QHash<QByteArray, const Data *>;
+    static QReadWriteLock &tableLock = *new QReadWriteLock;
+
+    // Most names have already been interned, so look for one without copying it
+    QByteArray key = QByteArray::fromRawData(name, size);
+    {
+        QReadLocker lock(&tableLock);
+        Q_UNUSED(lock);
+
+        const Data *data = table.value(key);
+        if (data)
+            return data;
+    }
+
+    QWriteLocker lock(&tableLock);
+    Q_UNUSED(lock);
+
+    // Another thread may have interned the name since the read lock was
+    // released
+    const Data *existing = table.value(key);
+    if (existing)
+        return existing;
+
+    Data *data = new Data;
+    data->name = QByteArray(name, size);
+    data->string = QString::fromUtf8(data->name);
+    data->hash = qHash(data->name);
+    data->wideHash = wideHash(name, size);
+    table.insert(data->name, data);
+
+    return data;
+} // const Atom::Data *Atom::intern(const char *name, int size)
+
+quint64 Atom::wideHash(const char *name, int size)
+{
+    // FNV-1a, finished as SplitMix64 is so that every bit depends on every byte
+    quint64 hash = Q_UINT64_C(0xcbf29ce484222325);
+    for (int i = 0; i < size; i++)
+    {
+        hash ^= quint8(name[i]);
+        hash *= Q_UINT64_C(0x100000001b3);
+    }
+
+    hash = (hash ^ (hash >> 30)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+    hash = (hash ^ (hash >> 27)) * Q_UINT64_C(0x94d049bb133111eb);
+    return hash ^ (hash >> 31);
+} // quint64 Atom::wideHash(const char *name, int size)
@@ -0,0 +1,212 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: atom.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+/*!
+ * \brief An interned name, such as the name of an object requested from a
+ * Builder or a key in a Configuration.
+ *
+ * Every Atom with the same name refers to the same immutable entry, which is
+ * created the first time the name is interned and kept until the program
+ * exits. The entry holds the name as UTF-8 and as a QString, along with its
+ * hash, so an Atom can be passed wherever a name is expected without copying,
+ * converting or hashing it again. Two Atoms are equal if and only if they
+ * refer to the same entry, so comparing them only compares pointers.
+ *
+ * Creating an Atom looks the name up in a global table, so Atoms are best
+ * created once, such as when a component is set up, and reused on every call
+ * after that. Since entries are never freed, names which are generated
+ * without bound should not be interned.
+ *
+ * \note Atom is thread-safe.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+class Atom
+{
+public:
+    /*!
+     * \brief Creates a null Atom, whose name is a null QByteArray.
+     */
+    Atom() :
+        _data(&NullData)
+    {
+    }
+
+    /*!
+     * \brief Interns a null-terminated name.
+     *
+     * \param name The name, encoded as UTF-8.
+     */
+    explicit Atom(const char *name);
+
+    /*!
+     * \brief Interns a name which need not be null-terminated.
+     *
+     * \param name The name, encoded as UTF-8.
+     * \param size The length of \c name, in bytes.
+     */
+    Atom(const char *name, int size);
+
+    /*!
+     * \brief Interns a name.
+     *
+     * \param name The name, encoded as UTF-8.
+     */
+    explicit Atom(const QByteArray &name);
+
+    /*!
+     * \brief Interns a name.
+     *
+     * \param name The name, which is converted to UTF-8.
+     */
+    explicit Atom(const QString &name);
+
+    /*!
+     * \brief Checks whether this Atom is null.
+     *
+     * \retval true This Atom was default-constructed.
+     * \retval false This Atom refers to an interned name.
+     */
+    bool isNull() const { return _data == &NullData; }
+
+    /*!
+     * \brief Gets the name, encoded as UTF-8.
+     *
+     * The returned QByteArray shares its data with the interned entry, so
+     * copying it allocates nothing.
+     */
+    const QByteArray &name() const { return _data->name; }
+
+    /*!
+     * \brief Gets a pointer to the null-terminated name, encoded as UTF-8.
+     *
+     * The pointer remains valid until the program exits.
+     */
+    const char *constData() const { return _data->name.constData(); }
+
+    /*!
+     * \brief Gets the length of the name, in bytes.
+     */
+    int size() const { return _data->name.size(); }
+
+    /*!
+     * \brief Gets the name as a QString, which was converted when the name was
+     * interned.
+     */
+    const QString &toString() const { return _data->string; }
+
+    /*!
+     * \brief Gets the hash of the name, which is equal to qHash(name()).
+     */
+    uint hash() const { return _data->hash; }
+
+    /*!
+     * \brief Gets the 64-bit hash of the name, which is equal to
+     * wideHash(constData(), size()).
+     */
+    quint64 wideHash() const { return _data->wideHash; }
+
+    /*!
+     * \brief Computes a 64-bit hash of a name.
+     *
+     * The hash is used where a 32-bit hash would collide too often, such as
+     * the perfect hash of a SealedTable.
+     *
+     * \param name The name, which need not be null-terminated.
+     * \param size The length of \c name, in bytes.
+     */
+    static quint64 wideHash(const char *name, int size);
+
+    /*!
+     * \brief Checks whether two Atoms have the same name.
+     */
+    bool operator==(const Atom &other) const { return _data == other._data; }
+
+    /*!
+     * \brief Checks whether two Atoms have different names.
+     */
+    bool operator!=(const Atom &other) const { return _data != other._data; }
+
+private:
+    /*!
+     * \brief An interned name.
+     */
+    struct Data
+    {
+        /*!
+         * \brief The name, encoded as UTF-8.
+         */
+        QByteArray name;
+
+        /*!
+         * \brief The name, as a QString.
+         */
+        QString string;
+
+        /*!
+         * \brief The hash of \c name.
+         */
+        uint hash;
+
+        /*!
+         * \brief The 64-bit hash of \c name.
+         */
+        quint64 wideHash;
+    };
+
+    /*!
+     * \brief Finds the interned entry for a name, creating it if there is none.
+     */
+    static const Data *intern(const char *name, int size);
+
+    /*!
+     * \brief The entry which null Atoms refer to.
+     */
+    static const Data NullData;
+
+    /*!
+     * \brief The interned entry.
+     */
+    const Data *_data;
+};
+
+Q_DECLARE_TYPEINFO(Atom, Q_PRIMITIVE_TYPE);
+
+/*!
+ * \brief Gets the hash of an Atom, which is computed only once, when its name
+ * is interned.
+ */
+inline uint qHash(const Atom &atom, uint seed = 0)
+{
+    return atom.hash() ^ seed;
+}
@@ -39,134 +39,2014 @@
 ********************************************************************** */
 
 #include "builder.h"
+#include "sealedtable.h"
+#include "tracer.h"
+
+#include <QElapsedTimer>
+#include <QMetaMethod>
+#include <QRunnable>
+#include <QScopedPointer>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+#include <QVarLengthArray>
+#include <QVector>
+
+const char Builder::InjectedObjectsName[] = "SafeDartInjectedObjects";
+
+namespace
+{
+    /*!
+     * \brief An object being constructed by a Builder on the current thread.
+     */
+    struct Construction
+    {
+        Builder *builder;
+        InstanceTable::Instance *instance;
+    };
+
+    /*!
+     * \brief The objects being constructed on the current thread, innermost
+     * last.
+     */
+    thread_local QVector<Construction> constructions;
+
+    /*!
+     * \brief An object which has been created, but which lifecycle hooks have
+     * not yet been told about.
+     */
+    struct CreatedObject
+    {
+        Builder *builder;
+        QSharedPointer<QObject> object;
+    };
+
+    /*!
+     * \brief The number of DeliveryBatches open on this thread.
+     */
+    thread_local int deliveryDepth = 0;
+
+    /*!
+     * \brief The objects created on this thread since the outermost
+     * DeliveryBatch was opened.
+     */
+    thread_local QVector<CreatedObject> createdObjects;
+
+    /*!
+     * \brief A LifecycleHook which emits Builder's createdObject and
+     * destroyingObject signals.
+     */
+    class SignalLifecycleHook : public LifecycleHook
+    {
+    public:
+        void objectsCreated(Builder *builder, const QList<QSharedPointer<QObject>> &objects) override
+        {
+            for (const QSharedPointer<QObject> &object : objects)
+                emit builder->createdObject(object);
+        }
+
+        void objectDestroying(Builder *builder, QObject *object) override
+        {
+            emit builder->destroyingObject(object);
+        }
+    };
+
+    /*!
+     * \brief Marks an object as being constructed on the current thread for as
+     * long as it exists.
+     */
+    class ConstructionScope
+    {
+    public:
+        ConstructionScope(Builder *builder, InstanceTable::Instance *instance)
+        {
+            constructions.append(Construction { builder, instance });
+        }
+
+        ~ConstructionScope()
+        {
+            constructions.removeLast();
+        }
+    };
+
+    /*!
+     * \brief Checks whether an Instance's object is being constructed by the
+     * given Builder on the current thread.
+     */
+    bool isConstructing(Builder *builder, InstanceTable::Instance *instance)
+    {
+        for (const Construction &construction : constructions)
+        {
+            if (construction.builder == builder && construction.instance == instance)
+                return true;
+        }
+
+        return false;
+    }
+
+    /*!
+     * \brief Finds the QMetaObject for a class name, preferring types
+     * registered with FactoryRegistry.
+     *
+     * \return The QMetaObject, or null if the class is not known.
+     */
+    const QMetaObject *lookUpMetaObject(const QByteArray &className)
+    {
+        const FactoryRegistry::Entry *factories = FactoryRegistry::find(className);
+        if (factories)
+            return factories->metaObject;
+
+        return QMetaType::metaObjectForType(QMetaType::type(className + '*'));
+    }
+
+    /*!
+     * \brief Works out how Builder can supply a constructor parameter.
+     *
+     * \param type The normalized type of the parameter.
+     * \param parameter Receives the plan for the parameter.
+     *
+     * \return Whether Builder can supply the parameter.
+     */
+    bool planParameter(const QByteArray &type, InstanceTable::Parameter *parameter)
+    {
+        parameter->injectable = nullptr;
+        if (type == "Builder*")
+        {
+            parameter->kind = InstanceTable::Parameter::BuilderParameter;
+            return true;
+        }
+
+        static const QByteArray sharedPointer("QSharedPointer<");
+        QByteArray name;
+        if (type.startsWith(sharedPointer) && type.endsWith('>'))
+        {
+            parameter->kind = InstanceTable::Parameter::SharedPointerParameter;
+            name = type.mid(sharedPointer.size(), type.size() - sharedPointer.size() - 1);
+        }
+        else if (type.endsWith('*'))
+        {
+            parameter->kind = InstanceTable::Parameter::PointerParameter;
+            name = type.left(type.size() - 1);
+        }
+        else
+        {
+            return false;
+        }
+
+        parameter->injectable = FactoryRegistry::findInjectable(name);
+        return parameter->injectable != nullptr;
+    }
+
+    /*!
+     * \brief Keeps objects which were injected by pointer alive for as long as
+     * the object they were injected into, whose child it is.
+     *
+     * A child, rather than the object's deleter, holds the references, since a
+     * pooled object outlives each of its deleters while idle in its pool. It
+     * is named Builder::InjectedObjectsName so that it can be recognized.
+     */
+    class InjectedObjects : public QObject
+    {
+    public:
+        InjectedObjects(const QList<QSharedPointer<QObject>> &objects, QObject *parent) :
+            QObject(parent),
+            _objects(objects)
+        {
+            setObjectName(QLatin1String(Builder::InjectedObjectsName));
+        }
+
+    private:
+        QList<QSharedPointer<QObject>> _objects;
+    };
+
+    /*!
+     * \brief The arguments injected into a constructor, which are destroyed
+     * along with it.
+     */
+    class InjectedArguments
+    {
+    public:
+        explicit InjectedArguments(int count) :
+            _arguments(count),
+            _destroy(count)
+        {
+            for (int i = 0; i < count; i++)
+                _destroy[i] = nullptr;
+        }
+
+        ~InjectedArguments()
+        {
+            for (int i = 0; i < _destroy.size(); i++)
+            {
+                if (_destroy[i])
+                    _destroy[i](&_arguments[i]);
+            }
+        }
+
+        /*!
+         * \brief Converts an object to the argument at the given index.
+         *
+         * \return The argument, or null if the object does not implement the
+         * parameter's interface.
+         */
+        void *set(int index, const InstanceTable::Parameter &parameter, const QSharedPointer<QObject> &object)
+        {
+            FactoryRegistry::Argument *argument = &_arguments[index];
+            bool converted;
+            if (parameter.kind == InstanceTable::Parameter::SharedPointerParameter)
+            {
+                converted = parameter.injectable->toSharedPointer(argument, object);
+                _destroy[index] = parameter.injectable->destroySharedPointer;
+            }
+            else
+            {
+                converted = parameter.injectable->toPointer(argument, object);
+                _pointed.append(object);
+            }
+
+            return converted ? argument : nullptr;
+        }
+
+        /*!
+         * \brief Keeps the objects passed by pointer alive for as long as the
+         * given object exists.
+         */
+        void keepAlive(QObject *object)
+        {
+            if (!_pointed.isEmpty())
+                new InjectedObjects(_pointed, object);
+        }
+
+    private:
+        QVarLengthArray<FactoryRegistry::Argument, 8> _arguments;
+        QVarLengthArray<void (*)(FactoryRegistry::Argument *), 8> _destroy;
+        QList<QSharedPointer<QObject>> _pointed;
+    };
+
+    /*!
+     * \brief Gets a single object from a Builder on a QThreadPool, on behalf of
+     * Builder::prewarm().
+     */
+    class PrewarmTask : public QRunnable
+    {
+    public:
+        PrewarmTask(Builder *builder, const QByteArray &name,
+                    QHash<QByteArray, QSharedPointer<QObject>> *objects, QMutex *objectsMutex) :
+            _builder(builder),
+            _name(name),
+            _objects(objects),
+            _objectsMutex(objectsMutex)
+        {
+        }
+
+        void run() override
+        {
+            QSharedPointer<QObject> object;
+            try
+            {
+                object = _builder->get(_name.constData());
+            }
+            catch (...)
+            {
+                // Prewarming is only an optimization; the error will be
+                // reported when the name is actually requested
+                return;
+            }
+
+            QMutexLocker lock(_objectsMutex);
+            Q_UNUSED(lock);
+            _objects->insert(_name, object);
+        }
+
+    private:
+        Builder *_builder;
+        QByteArray _name;
+        QHash<QByteArray, QSharedPointer<QObject>> *_objects;
+        QMutex *_objectsMutex;
+    };
+}
+
+// ********************************************************************** */
+class Builder::AsyncGetTask : public QRunnable
+// ********************************************************************** */
+{
+public:
+    AsyncGetTask(Builder *builder, const char *name, const QByteArray &shared, const AsyncCallback &callback) :
+        _builder(builder),
+        _name(name),
+        _shared(shared),
+        _callback(callback)
+    {
+    }
+
+    void run() override
+    {
+        QSharedPointer<QObject> object;
+        QScopedPointer<QException> error;
+        try
+        {
+            object = _builder->get(_name.constData());
+        }
+        catch (const QException &exception)
+        {
+            error.reset(exception.clone());
+        }
+        catch (...)
+        {
+            QString message = QString("Failed to create %1.").arg(QString(_name));
+            error.reset(new BuilderException(message));
+        }
+
+        // Collect everyone who asked for the object in the meantime. Anyone
+        // who asks after this point will find the object already created.
+        QList<AsyncCallback> callbacks;
+        if (!_shared.isNull())
+        {
+            QMutexLocker lock(&_builder->_pendingGetsMutex);
+            Q_UNUSED(lock);
+            callbacks = _builder->_pendingGets.take(_shared);
+        }
+        else
+        {
+            callbacks.append(_callback);
+        }
+
+        for (const AsyncCallback &callback : callbacks)
+            callback(object, error.data());
+    }
+
+private:
+    Builder *_builder;
+    QByteArray _name;
+    QByteArray _shared;
+    AsyncCallback _callback;
+}; // class Builder::AsyncGetTask : public QRunnable
+
+// ********************************************************************** */
+class Builder::DeliveryBatch
+// ********************************************************************** */
+{
+public:
+    DeliveryBatch()
+    {
+        deliveryDepth++;
+    }
+
+    ~DeliveryBatch()
+    {
+        if (--deliveryDepth > 0 || createdObjects.isEmpty())
+            return;
+
+        // Take the batch before delivering it, so that any objects the hooks
+        // create form a batch of their own
+        QVector<CreatedObject> batch;
+        batch.swap(createdObjects);
+
+        // Deliver each run of objects created by the same Builder together
+        int start = 0;
+        while (start < batch.size())
+        {
+            Builder *builder = batch.at(start).builder;
+            QList<QSharedPointer<QObject>> objects;
+            int end = start;
+            for (; end < batch.size() && batch.at(end).builder == builder; end++)
+                objects.append(batch.at(end).object);
+
+            builder->deliverCreated(objects);
+            start = end;
+        }
+    }
+}; // class Builder::DeliveryBatch
+
+/*!
+ * \brief State shared between a Builder and the deleters of the objects it
+ * creates.
+ *
+ * An object may outlive the Builder which created it, such as a scoped object
+ * which a caller still holds once its scope is destroyed. The Builder marks
+ * its Lifeline dead before tearing down its hooks and pools, so such an object
+ * is then simply deleted.
+ */
+struct Builder::Lifeline
+{
+    Lifeline() :
+        lock(QReadWriteLock::Recursive),
+        alive(true)
+    {
+    }
+
+    /*!
+     * \brief Reports an object which the Builder created as being destroyed,
+     * if the Builder still exists.
+     *
+     * \param builder The Builder which created the object.
+     * \param metrics The metrics counting the object as live, if any.
+     * \param object The object being destroyed.
+     */
+    void destroying(Builder *builder, BindingMetrics *metrics, QObject *object)
+    {
+        QReadLocker locker(&lock);
+        Q_UNUSED(locker);
+
+        if (!alive)
+            return;
+
+        if (metrics)
+            metrics->live.deref();
+        builder->notifyDestroying(object);
+    }
+
+    /*!
+     * \brief Returns an object to the pool it was acquired from, if the
+     * Builder, and with it the pool, still exists.
+     *
+     * \retval true The pool kept the object.
+     * \retval false The object must be deleted.
+     */
+    bool release(InstancePool *pool, QObject *object)
+    {
+        QReadLocker locker(&lock);
+        Q_UNUSED(locker);
+
+        return alive && pool->release(object);
+    }
+
+    /*!
+     * \brief Held for reading while a deleter reports to the Builder, and for
+     * writing while the Builder marks itself dead.
+     */
+    QReadWriteLock lock;
+
+    /*!
+     * \brief Whether the Builder, its hooks and its Instances still exist.
+     */
+    bool alive;
+};
+
+// ********************************************************************** */
+Builder::Builder(QObject *parent) :
+    QObject(parent),
+    _parent(nullptr),
+    _sealing(false),
+    _lifeline(new Lifeline)
+// ********************************************************************** */
+{
+    qRegisterMetaType<QSharedPointer<QObject>>();
+
+} // Builder::Builder(QObject *parent)
+
+// ********************************************************************** */
+Builder::Builder(Builder *scopeParent, QObject *parent) :
+    QObject(parent),
+    _parent(scopeParent),
+    _arena(new Arena),
+    _instances(_arena.data()),
+    _sealing(false),
+    _lifeline(new Lifeline)
+// ********************************************************************** */
+{
+} // Builder::Builder(Builder *scopeParent, QObject *parent)
+
+// ********************************************************************** */
+Builder::~Builder()
+// ********************************************************************** */
+{
+    // Tear down everything a scope created, along with its Instances, before
+    // the rest of the Builder
+    _arena.reset();
+
+    // Objects which are still held elsewhere no longer report to the Builder;
+    // wait for any which are reporting now
+    {
+        QWriteLocker lock(&_lifeline->lock);
+        Q_UNUSED(lock);
+        _lifeline->alive = false;
+    }
+
+    delete _hooks.load();
+    qDeleteAll(_retiredHooks);
+
+    delete _sealed.load();
+    qDeleteAll(_retiredResolutions);
+} // Builder::~Builder()
+
+// ********************************************************************** */
+void Builder::addLifecycleHook(LifecycleHook *hook)
+// ********************************************************************** */
+{
+    QMutexLocker lock(&_hooksMutex);
+    Q_UNUSED(lock);
+
+    // Readers never lock, so the list is replaced rather than modified, and
+    // the old list is kept until the Builder is destroyed
+    QList<LifecycleHook *> *hooks = _hooks.loadAcquire();
+    QList<LifecycleHook *> *replacement = hooks ? new QList<LifecycleHook *>(*hooks) : new QList<LifecycleHook *>;
+    replacement->append(hook);
+    _hooks.storeRelease(replacement);
+
+    if (hooks)
+        _retiredHooks.append(hooks);
+} // void Builder::addLifecycleHook(LifecycleHook *hook)
+
+// ********************************************************************** */
+QSharedPointer<Configuration> Builder::configuration()
+// ********************************************************************** */
+{
+    if (_parent)
+        return _parent->configuration();
+
+    return _configuration;
+} // QSharedPointer<Configuration> Builder::configuration()
+
+// ********************************************************************** */
+QSharedPointer<Builder> Builder::createScope()
+// ********************************************************************** */
+{
+    return QSharedPointer<Builder>(new Builder(this, nullptr));
+} // QSharedPointer<Builder> Builder::createScope()
+
+// ********************************************************************** */
+QSharedPointer<QObject> Builder::get(const char *name)
+// ********************************************************************** */
+{
+    SAFEDART_METRIC(QElapsedTimer timer; timer.start());
+
+    InstanceTable::Guard guard(rootInstances());
+    Q_UNUSED(guard);
+
+    // Resolve the name to the Instance for the object with the correct name,
+    // creating it if it doesn't exist
+    Resolution &resolution = resolve(name);
+
+    // If this thread is constructing another object, that object depends on
+    // this one
+    noteDependency(name);
+
+    QSharedPointer<QObject> result = getResolved(name, resolution);
+
+    SAFEDART_METRIC(BindingMetrics &metrics = resolution.requested->metrics());
+    SAFEDART_METRIC(metrics.gets.ref());
+    SAFEDART_METRIC(metrics.getLatency.record(timer.nsecsElapsed()));
+
+    return result;
+} // QSharedPointer<QObject> Builder::get(const char *name)
+
+// ********************************************************************** */
+QSharedPointer<QObject> Builder::get(const Atom &name)
+// ********************************************************************** */
+{
+    SAFEDART_METRIC(QElapsedTimer timer; timer.start());
+
+    InstanceTable::Guard guard(rootInstances());
+    Q_UNUSED(guard);
+
+    // As get(const char *), resolving the name by its Atom
+    Resolution &resolution = resolve(name);
+    noteDependency(name.constData());
+
+    QSharedPointer<QObject> result = getResolved(name.constData(), resolution);
+
+    SAFEDART_METRIC(BindingMetrics &metrics = resolution.requested->metrics());
+    SAFEDART_METRIC(metrics.gets.ref());
+    SAFEDART_METRIC(metrics.getLatency.record(timer.nsecsElapsed()));
+
+    return result;
+} // QSharedPointer<QObject> Builder::get(const Atom &name)
+
+// ********************************************************************** */
+GetResult<QObject> Builder::tryGet(const char *name)
+// ********************************************************************** */
+{
+    InstanceTable::Guard guard(rootInstances());
+    Q_UNUSED(guard);
+
+    Resolution &resolution = resolve(name);
+    Instance &instance = *resolution.instance;
+
+    // Names which cannot be constructed are reported without throwing. Scopes
+    // may hold objects provided to them alone, so only the root Builder checks.
+    // A published plan shows the type was already found and is constructible.
+    if (!_parent && instance._reference.isNull() && !instance._plan.loadAcquire())
+    {
+        if (!findMetaObject(instance))
+            return GetResult<QObject>(NotFoundError, name, instance._name);
+        if (!constructionPlan(name, instance))
+            return GetResult<QObject>(NotCreatedError, name, instance._name);
+    }
+
+    // Anything else that goes wrong, such as a dependency which cannot be
+    // found, is only discovered during construction
+    try
+    {
+        return GetResult<QObject>(get(name));
+    }
+    catch (const BuilderException &exception)
+    {
+        return GetResult<QObject>(NotCreatedError, name, instance._name, exception.what());
+    }
+} // GetResult<QObject> Builder::tryGet(const char *name)
+
+// ********************************************************************** */
+QFuture<QSharedPointer<QObject>> Builder::getAsync(const char *name, QThreadPool *pool)
+// ********************************************************************** */
+{
+    return getAsync<QObject>(name, pool);
+} // QFuture<QSharedPointer<QObject>> Builder::getAsync(const char *name, QThreadPool *pool)
+
+// ********************************************************************** */
+void Builder::getAsync(const char *name, QThreadPool *pool, const AsyncCallback &callback)
+// ********************************************************************** */
+{
+    InstanceTable::Guard guard(rootInstances());
+    Q_UNUSED(guard);
+
+    Resolution &resolution = resolve(name);
+
+    // If a shared object already exists, there's nothing to wait for
+    if (!_parent && resolution.lifetime == InstanceTable::SharedLifetime)
+    {
+        QSharedPointer<QObject> existing = resolution.instance->_reference;
+        if (existing)
+        {
+            if (_prewarmedCount.loadAcquire())
+                releasePrewarmed(*resolution.instance);
+            callback(existing, nullptr);
+            return;
+        }
+    }
+
+    // Join the construction already in progress, if there is one. Pooled
+    // objects are never shared, so each request gets a construction of its
+    // own.
+    QByteArray shared;
+    if (resolution.lifetime != InstanceTable::PooledLifetime)
+    {
+        shared = resolution.instance->_name;
+
+        QMutexLocker lock(&_pendingGetsMutex);
+        Q_UNUSED(lock);
+
+        auto pending = _pendingGets.find(shared);
+        if (pending != _pendingGets.end())
+        {
+            pending->append(callback);
+            return;
+        }
+
+        _pendingGets[shared].append(callback);
+    }
+
+    if (!pool)
+        pool = QThreadPool::globalInstance();
+    pool->start(new AsyncGetTask(this, name, shared, callback));
+} // void Builder::getAsync(const char *name, QThreadPool *pool, const AsyncCallback &callback)
+
+// ********************************************************************** */
+QList<QSharedPointer<QObject>> Builder::getAll(const QList<QByteArray> &names)
+// ********************************************************************** */
+{
+    InstanceTable::Guard guard(rootInstances());
+    Q_UNUSED(guard);
+
+    // Resolve every name in one pass, then get each object in order. Objects
+    // which already exist are returned without locking; missing objects are
+    // constructed in order, so any that depend on earlier ones find them ready.
+    QVector<Resolution *> resolutions = resolve(names);
+
+    // Lifecycle hooks are told about all of the objects at once
+    DeliveryBatch batch;
+    Q_UNUSED(batch);
+
+    QList<QSharedPointer<QObject>> objects;
+    objects.reserve(names.size());
+    for (int i = 0; i < names.size(); i++)
+    {
+        SAFEDART_METRIC(QElapsedTimer timer; timer.start());
+
+        const char *name = names.at(i).constData();
+        noteDependency(name);
+        objects.append(getResolved(name, *resolutions.at(i)));
+
+        SAFEDART_METRIC(BindingMetrics &metrics = resolutions.at(i)->requested->metrics());
+        SAFEDART_METRIC(metrics.gets.ref());
+        SAFEDART_METRIC(metrics.getLatency.record(timer.nsecsElapsed()));
+    }
+
+    return objects;
+} // QList<QSharedPointer<QObject>> Builder::getAll(const QList<QByteArray> &names)
+
+// ********************************************************************** */
+QList<QSharedPointer<QObject>> Builder::getListed(const QList<QByteArray> &names)
+// ********************************************************************** */
+{
+    InstanceTable::Guard guard(rootInstances());
+    Q_UNUSED(guard);
+
+    // Resolve the names for their lifetimes, but get the object of each name
+    // itself. The names are already implementations, so mapping them again
+    // (such as through Impl=Other) would swap one for another.
+    QVector<Resolution *> resolutions = resolve(names);
+
+    DeliveryBatch batch;
+    Q_UNUSED(batch);
+
+    QList<QSharedPointer<QObject>> objects;
+    objects.reserve(names.size());
+    for (int i = 0; i < names.size(); i++)
+    {
+        SAFEDART_METRIC(QElapsedTimer timer; timer.start());
+
+        const Resolution &resolution = *resolutions.at(i);
+        Resolution listed;
+        listed.stamp.storeRelease(resolution.stamp.loadAcquire());
+        listed.instance = resolution.requested;
+        listed.requested = resolution.requested;
+        listed.lifetime = resolution.lifetime;
+
+        const char *name = names.at(i).constData();
+        noteDependency(name);
+        objects.append(getResolved(name, listed));
+
+        SAFEDART_METRIC(BindingMetrics &metrics = listed.requested->metrics());
+        SAFEDART_METRIC(metrics.gets.ref());
+        SAFEDART_METRIC(metrics.getLatency.record(timer.nsecsElapsed()));
+    }
+
+    return objects;
+} // QList<QSharedPointer<QObject>> Builder::getListed(const QList<QByteArray> &names)
+
+// ********************************************************************** */
+Builder::Collection Builder::getMulti(const char *name)
+// ********************************************************************** */
+{
+    Builder *root = this;
+    while (root->_parent)
+        root = root->_parent;
+
+    // As in resolve(), the stamp must be read before the Configuration
+    QByteArray key = name;
+    quint64 stamp = resolutionStamp();
+    int provisions = root->_provisions.loadAcquire();
+
+    // Reuse the cached collection if it is current and still in use. If it is
+    // no longer in use, but all of its objects still exist, gather them into a
+    // new collection without getting them again.
+    QList<QSharedPointer<QObject>> objects;
+    bool gathered = false;
+    {
+        QReadLocker lock(&_multiBindingsLock);
+        Q_UNUSED(lock);
+
+        auto iter = _multiBindings.constFind(key);
+        if (iter != _multiBindings.constEnd() && iter->stamp == stamp && iter->provisions == provisions)
+        {
+            Collection collection = iter->collection.toStrongRef();
+            if (collection)
+                return collection;
+
+            gathered = true;
+            for (const QWeakPointer<QObject> &reference : iter->objects)
+            {
+                QSharedPointer<QObject> object = reference.toStrongRef();
+                if (!object)
+                {
+                    gathered = false;
+                    objects.clear();
+                    break;
+                }
+                objects.append(object);
+            }
+        }
+    }
+
+    // Otherwise, get every object bound to the name. A name bound to an empty
+    // list has no objects.
+    if (!gathered)
+    {
+        QVariant bound;
+        QSharedPointer<Configuration> configuration = this->configuration();
+        if (configuration)
+            bound = configuration->get(section() + "/" + QString::fromUtf8(key));
+
+        QList<QByteArray> names;
+        if (bound.isValid())
+        {
+            for (const QString &type : bound.toStringList())
+                names.append(type.toUtf8());
+        }
+        else
+        {
+            names.append(key);
+        }
+
+        objects = getListed(names);
+    }
+
+    Collection collection(new QList<QSharedPointer<QObject>>(objects));
+
+    // Threads which build the same collection at once produce equivalent
+    // results; the last one is kept
+    QWriteLocker lock(&_multiBindingsLock);
+    Q_UNUSED(lock);
+
+    MultiBinding &binding = _multiBindings[key];
+    binding.stamp = stamp;
+    binding.provisions = provisions;
+    binding.collection = collection;
+    binding.objects.clear();
+    for (const QSharedPointer<QObject> &object : objects)
+        binding.objects.append(object);
+
+    return collection;
+} // Builder::Collection Builder::getMulti(const char *name)
+
+// ********************************************************************** */
+QSharedPointer<QObject> Builder::getResolved(const char *name, Resolution &resolution)
+// ********************************************************************** */
+{
+    SAFEDART_METRIC(BindingMetrics &metrics = resolution.requested->metrics());
+
+    // A scope only creates objects whose lifetime is scoped. Other objects come
+    // from its parent, unless one has been provided to the scope itself.
+    // Scopes resolve names the same way as their parents, so the resolution
+    // can be passed on as-is.
+    if (_parent && resolution.lifetime != InstanceTable::ScopedLifetime)
+    {
+        Instance *provided = _instances.find(resolution.instance->_name);
+        QSharedPointer<QObject> result = provided ? provided->_reference.toStrongRef() : QSharedPointer<QObject>();
+        if (result)
+        {
+            SAFEDART_METRIC(metrics.hits.ref());
+            return result;
+        }
+
+        return _parent->getResolved(name, resolution);
+    }
+
+    // Objects with a pooled lifetime are never shared
+    if (resolution.lifetime == InstanceTable::PooledLifetime)
+        return getPooled(name, resolution);
+
+    // Scopes keep their own Instances; names resolve to Instances of the root
+    // Builder
+    Instance &instance = _parent ? _instances[resolution.instance->_name] : *resolution.instance;
+
+    // Get the existing reference to that object, return it if there is one
+    QSharedPointer<QObject> result = instance._reference;
+    if(result){
+        SAFEDART_METRIC(metrics.hits.ref());
+        if (_prewarmedCount.loadAcquire())
+            releasePrewarmed(instance);
+        return result;
+
+    }
+    // Lifecycle hooks are told about the object once the lock below has been
+    // released, along with any objects created while constructing it
+    DeliveryBatch batch;
+    Q_UNUSED(batch);
+
+    // An object which depends on itself would wait forever for its own lock
+    if (isConstructing(this, &instance))
+    {
+        QString message = QString("Circular dependency on %1 for use as %2.")
+                .arg(QString(instance._name))
+                .arg(name);
+        throw BuilderException(message);
+    }
+
+    // No object exists--lock the reference to ensure that only one thread is
+    // creating an instance at a time
+    SAFEDART_METRIC(QElapsedTimer lockTimer; lockTimer.start());
+    QMutexLocker referenceLock(&instance._referenceMutex);
+    Q_UNUSED(referenceLock);
+    SAFEDART_METRIC(metrics.lockWait.record(lockTimer.nsecsElapsed()));
+
+    // The Instance may have been reclaimed while this thread was waiting; if
+    // so, any object created now would be lost along with it
+    if (instance._reclaimed.loadAcquire())
+    {
+        referenceLock.unlock();
+        return getResolved(name, resolve(name));
+    }
+
+    // Another thread could have been in the process of creating an instance;
+    // check that there's still no instance
+    result = instance._reference;
+    if(result)
+    {
+        SAFEDART_METRIC(metrics.hits.ref());
+        return result;
+    }
+    // Look up how to construct the object. Plans are shared with the root
+    // Builder.
+    const ConstructionPlan *plan = constructionPlan(name, *resolution.instance);
+
+    // Create an instance of the object using the planned constructor. Throw an
+    // exception if neither T(Builder *) nor T() is available, or construction
+    // fails.
+    QObject *object = nullptr;
+    if (plan)
+    {
+        SAFEDART_METRIC(QElapsedTimer constructionTimer; constructionTimer.start());
+
+        Tracer::Span span("builder", instance._name.constData(), name);
+        Q_UNUSED(span);
+        ConstructionScope scope(this, &instance);
+        Q_UNUSED(scope);
+        object = construct(*plan);
+
+        SAFEDART_METRIC(metrics.constructionTime.record(constructionTimer.nsecsElapsed()));
+    }
+    if (!object)
+    {
+        QString message = QString("Failed to create %1 for use as %2.")
+                .arg(QString(instance._name))
+                .arg(name);
+        throw BuilderException(message);
+    }
+
+    SAFEDART_METRIC(metrics.misses.ref());
+    SAFEDART_METRIC(metrics.live.ref());
+    BindingMetrics *liveMetrics = nullptr;
+    SAFEDART_METRIC(liveMetrics = &metrics);
+
+    // Wrap the created object in a QSharedPointer that notifies lifecycle
+    // hooks prior to deleting the object, if the Builder still exists
+    QSharedPointer<Lifeline> lifeline = _lifeline;
+    result = QSharedPointer<QObject>(object, [=](QObject *object)
+    {
+        lifeline->destroying(this, liveMetrics, object);
+        delete object;
+    });
+
+    // Store a reference to the object in the Instance. A scope also keeps the
+    // object alive until the scope is destroyed.
+    instance._reference = result;
+    if (_arena)
+        _arena->create<QSharedPointer<QObject>>(result);
+
+    // Queue the newly-created object for lifecycle hooks
+    notifyCreated(result);
+
+    // Return the created object
+    return result;
+} // QSharedPointer<QObject> Builder::getResolved(const char *name, Resolution &resolution)
+
+// ********************************************************************** */
+QSharedPointer<QObject> Builder::getPooled(const char *name, Resolution &resolution)
+// ********************************************************************** */
+{
+    Instance &instance = *resolution.instance;
+    SAFEDART_METRIC(BindingMetrics &metrics = resolution.requested->metrics());
+
+    const ConstructionPlan *plan = constructionPlan(name, instance);
+    if (!plan)
+    {
+        QString message = QString("Failed to create %1 for use as %2.")
+                .arg(QString(instance._name))
+                .arg(name);
+        throw BuilderException(message);
+    }
+    if (isConstructing(this, &instance))
+    {
+        QString message = QString("Circular dependency on %1 for use as %2.")
+                .arg(QString(instance._name))
+                .arg(name);
+        throw BuilderException(message);
+    }
+
+    // Create the pool on first use, sized by the name's own @pool_size key if
+    // it has one, or by the section's otherwise
+    InstancePool *pool = instance._pool.loadAcquire();
+    if (!pool)
+    {
+        int capacity = DefaultPoolCapacity;
+        QSharedPointer<Configuration> configuration = this->configuration();
+        if (configuration)
+        {
+            QString prefix = section() + "/";
+            capacity = configuration->get(prefix + "@pool_size", capacity).toInt();
+            capacity = configuration->get(prefix + QString::fromUtf8(name) + "/@pool_size", capacity).toInt();
+        }
+
+        InstancePool *newPool = new InstancePool(plan->metaObject, capacity);
+        if (!instance._pool.testAndSetOrdered(nullptr, newPool))
+            delete newPool;
+        pool = instance._pool.loadAcquire();
+    }
+
+    // Instances with pools are never reclaimed, but this one may have been
+    // reclaimed before its pool was added; its pool would then be deleted
+    // while objects still refer to it
+    if (instance._reclaimed.loadAcquire())
+        return getPooled(name, resolve(name));
+
+    DeliveryBatch batch;
+    Q_UNUSED(batch);
+
+    // Reuse an idle object if there is one; otherwise, create one
+    QObject *object = pool->acquire();
+    bool created = !object;
+    if (created)
+    {
+        SAFEDART_METRIC(QElapsedTimer constructionTimer; constructionTimer.start());
+
+        Tracer::Span span("builder", instance._name.constData(), name);
+        Q_UNUSED(span);
+        ConstructionScope scope(this, &instance);
+        Q_UNUSED(scope);
+        object = construct(*plan);
+
+        SAFEDART_METRIC(metrics.constructionTime.record(constructionTimer.nsecsElapsed()));
+    }
+    if (!object)
+    {
+        QString message = QString("Failed to create %1 for use as %2.")
+                .arg(QString(instance._name))
+                .arg(name);
+        throw BuilderException(message);
+    }
+
+    SAFEDART_METRIC(created ? metrics.misses.ref() : metrics.hits.ref());
+    SAFEDART_METRIC(if (created) metrics.live.ref());
+    BindingMetrics *liveMetrics = nullptr;
+    SAFEDART_METRIC(liveMetrics = &metrics);
+
+    // Return the object to the pool once released; it is only deleted if the
+    // pool is full, or is gone along with the Builder
+    QSharedPointer<Lifeline> lifeline = _lifeline;
+    QSharedPointer<QObject> result(object, [=](QObject *object)
+    {
+        if (lifeline->release(pool, object))
+            return;
+
+        lifeline->destroying(this, liveMetrics, object);
+        delete object;
+    });
+
+    if (created)
+        notifyCreated(result);
+
+    return result;
+} // QSharedPointer<QObject> Builder::getPooled(const char *name, Resolution &resolution)
+
+// ********************************************************************** */
+const Builder::ConstructionPlan *Builder::constructionPlan(const char *name, Instance &instance)
+// ********************************************************************** */
+{
+    const ConstructionPlan *plan = instance._plan.loadAcquire();
+    if (plan)
+        return plan;
+
+    // The first time, the plan is worked out from the QMetaObject for the
+    // object name, which types registered with FactoryRegistry provide
+    // directly; throw an exception if none is found
+    const QMetaObject *metaObject = findMetaObject(instance);
+    if (!metaObject)
+    {
+        QString message = QString("Could not find %1 for use as %2.")
+                .arg(QString(instance._name))
+                .arg(name);
+        throw BuilderException(message);
+    }
+
+    // Scopes and pools may be planning the same type without holding the
+    // Instance's lock; keep whichever plan is published first
+    ConstructionPlan *newPlan = planConstruction(metaObject);
+    if (newPlan && !instance._plan.testAndSetOrdered(nullptr, newPlan))
+    {
+        delete newPlan;
+        newPlan = nullptr;
+    }
+
+    return newPlan ? newPlan : instance._plan.loadAcquire();
+} // const Builder::ConstructionPlan *Builder::constructionPlan(const char *name, Instance &instance)
+
+// ********************************************************************** */
+const QMetaObject *Builder::findMetaObject(Instance &instance)
+// ********************************************************************** */
+{
+    // The revision must be read before looking, so that types added during
+    // the lookup cause the name to be looked up again
+    int revision = FactoryRegistry::revision();
+    if (instance._missing.loadAcquire() == revision + 1)
+        return nullptr;
+
+    const QMetaObject *metaObject = lookUpMetaObject(instance._name);
+    if (!metaObject)
+        instance._missing.storeRelease(revision + 1);
+
+    return metaObject;
+} // const QMetaObject *Builder::findMetaObject(Instance &instance)
+
+// ********************************************************************** */
+QObject *Builder::construct(const ConstructionPlan &plan)
+// ********************************************************************** */
+{
+    // Call the registered factory if there is one
+    if (plan.factory)
+        return plan.factory(this);
+
+    // Otherwise, invoke the constructor directly, as QMetaObject::newInstance
+    // would once it had found it. The first argument receives the created
+    // object.
+    QObject *object = nullptr;
+    Builder *builder = this;
+    if (plan.parameters.isEmpty() || plan.takesBuilder)
+    {
+        void *arguments[] = { &object, &builder };
+        if (!plan.takesBuilder)
+            arguments[1] = nullptr;
+
+        plan.metaObject->static_metacall(QMetaObject::CreateInstance, plan.constructor, arguments);
+        return object;
+    }
+
+    // Get each object to inject. They are gotten while the object is being
+    // constructed, so they are also recorded as its dependencies.
+    InjectedArguments injected(plan.parameters.size());
+    QVarLengthArray<void *, 8> arguments;
+    arguments.append(&object);
+    for (int i = 0; i < plan.parameters.size(); i++)
+    {
+        const Parameter &parameter = plan.parameters.at(i);
+        if (parameter.kind == Parameter::BuilderParameter)
+        {
+            arguments.append(&builder);
+            continue;
+        }
+
+        QSharedPointer<QObject> dependency = get(parameter.injectable->iid);
+        void *argument = injected.set(i, parameter, dependency);
+        if (!argument)
+        {
+            QString message = QString("%1 does not implement %2.")
+                    .arg(dependency->metaObject()->className())
+                    .arg(parameter.injectable->iid);
+            throw BuilderException(message);
+        }
+        arguments.append(argument);
+    }
+
+    plan.metaObject->static_metacall(QMetaObject::CreateInstance, plan.constructor, arguments.data());
+    if (object)
+        injected.keepAlive(object);
+    return object;
+} // QObject *Builder::construct(const ConstructionPlan &plan)
+
+// ********************************************************************** */
+QSharedPointer<QObject> Builder::createTransient(const char *name, Resolution &resolution, const ConstructionPlan &plan)
+// ********************************************************************** */
+{
+    Instance &instance = *resolution.instance;
+    SAFEDART_METRIC(BindingMetrics &metrics = resolution.requested->metrics());
+    SAFEDART_METRIC(metrics.gets.ref());
+
+    // As with get(), an object being constructed by this thread depends on the
+    // name, and an object which creates itself would never finish
+    noteDependency(name);
+    if (isConstructing(this, &instance))
+    {
+        QString message = QString("Circular dependency on %1 for use as %2.")
+                .arg(QString(instance._name))
+                .arg(name);
+        throw BuilderException(message);
+    }
+
+    DeliveryBatch batch;
+    Q_UNUSED(batch);
+
+    SAFEDART_METRIC(QElapsedTimer constructionTimer; constructionTimer.start());
+
+    QObject *object = nullptr;
+    {
+        Tracer::Span span("builder", instance._name.constData(), name);
+        Q_UNUSED(span);
+        ConstructionScope scope(this, &instance);
+        Q_UNUSED(scope);
+        object = construct(plan);
+    }
+
+    SAFEDART_METRIC(metrics.constructionTime.record(constructionTimer.nsecsElapsed()));
+
+    if (!object)
+    {
+        QString message = QString("Failed to create %1 for use as %2.")
+                .arg(QString(instance._name))
+                .arg(name);
+        throw BuilderException(message);
+    }
+
+    SAFEDART_METRIC(metrics.misses.ref());
+    SAFEDART_METRIC(metrics.live.ref());
+    BindingMetrics *liveMetrics = nullptr;
+    SAFEDART_METRIC(liveMetrics = &metrics);
+
+    QSharedPointer<Lifeline> lifeline = _lifeline;
+    QSharedPointer<QObject> result(object, [=](QObject *object)
+    {
+        lifeline->destroying(this, liveMetrics, object);
+        delete object;
+    });
+
+    notifyCreated(result);
+    return result;
+} // QSharedPointer<QObject> Builder::createTransient(const char *name, Resolution &resolution, const ConstructionPlan &plan)
+
+// ********************************************************************** */
+Builder::ConstructionPlan *Builder::planConstruction(const QMetaObject *metaObject)
+// ********************************************************************** */
+{
+    // Use the invokable constructor with the most parameters which can all be
+    // supplied, so that T(Builder *) is preferred to T(), and constructors
+    // taking injected objects are preferred to both. Of constructors with as
+    // many parameters, the one taking the fewest Builders is preferred, so
+    // that T(Dep *) is preferred to T(Builder *) whichever is declared first.
+    // Remaining ties go to the constructor declared first.
+    int constructor = -1;
+    int builderCount = 0;
+    QVector<Parameter> parameters;
+    for (int i = 0; i < metaObject->constructorCount(); i++)
+    {
+        QList<QByteArray> types = metaObject->constructor(i).parameterTypes();
+        if (constructor >= 0 && types.size() < parameters.size())
+            continue;
+
+        QVector<Parameter> candidate(types.size());
+        int candidateBuilderCount = 0;
+        bool supplied = true;
+        for (int j = 0; j < types.size() && supplied; j++)
+        {
+            supplied = planParameter(types.at(j), &candidate[j]);
+            if (supplied && candidate.at(j).kind == Parameter::BuilderParameter)
+                candidateBuilderCount++;
+        }
+
+        if (supplied && (constructor < 0 || types.size() > parameters.size() || candidateBuilderCount < builderCount))
+        {
+            constructor = i;
+            builderCount = candidateBuilderCount;
+            parameters = candidate;
+        }
+    }
+    if (constructor < 0)
+        return nullptr;
+
+    bool takesBuilder = parameters.size() == 1 && parameters.first().kind == Parameter::BuilderParameter;
+
+    // Use the registered factory for the chosen constructor, if there is one.
+    // The factory is only used for the constructor which the QMetaObject
+    // chose, so that only invokable constructors are ever called.
+    const FactoryRegistry::Entry *factories = FactoryRegistry::find(metaObject->className());
+
+    ConstructionPlan *plan = new ConstructionPlan;
+    plan->metaObject = metaObject;
+    plan->constructor = constructor;
+    plan->takesBuilder = takesBuilder;
+    plan->parameters = parameters;
+    plan->factory = nullptr;
+    if (factories && factories->metaObject == metaObject)
+    {
+        if (takesBuilder)
+            plan->factory = factories->withBuilder;
+        else if (parameters.isEmpty())
+            plan->factory = factories->withNone;
+    }
+    return plan;
+} // Builder::ConstructionPlan *Builder::planConstruction(const QMetaObject *metaObject)
+
+// ********************************************************************** */
+QList<QByteArray> Builder::dependencies(const char *name)
+// ********************************************************************** */
+{
+    InstanceTable::Guard guard(rootInstances());
+    Q_UNUSED(guard);
+
+    Instance &instance = *resolve(name).instance;
+
+    // Objects injected into the constructor are known from the plan, before
+    // the object is first created
+    QSet<QByteArray> nameDependencies;
+    if (findMetaObject(instance))
+    {
+        const ConstructionPlan *plan = constructionPlan(name, instance);
+        if (plan)
+        {
+            for (const Parameter &parameter : plan->parameters)
+            {
+                if (parameter.injectable)
+                    nameDependencies.insert(parameter.injectable->iid);
+            }
+        }
+    }
+
+    QMutexLocker lock(&_dependenciesMutex);
+    Q_UNUSED(lock);
+    nameDependencies.unite(_dependencies.value(instance._name));
+    return nameDependencies.toList();
+} // QList<QByteArray> Builder::dependencies(const char *name)
 
 // ********************************************************************** */
-Builder::Builder(QObject *parent) :
-    QObject(parent)
+void Builder::connectNotify(const QMetaMethod &signal)
 // ********************************************************************** */
 {
-    qRegisterMetaType<QSharedPointer<QObject>>();
+    // The signals are emitted by a lifecycle hook, which is only installed
+    // once something connects to them
+    if (signal != QMetaMethod::fromSignal(&Builder::createdObject)
+            && signal != QMetaMethod::fromSignal(&Builder::destroyingObject))
+        return;
 
-} // Builder::Builder(QObject *parent)
+    if (!_signalHookInstalled.testAndSetOrdered(0, 1))
+        return;
+
+    _signalHook.reset(new SignalLifecycleHook);
+    addLifecycleHook(_signalHook.data());
+} // void Builder::connectNotify(const QMetaMethod &signal)
 
 // ********************************************************************** */
-Builder::~Builder()
+void Builder::deliverCreated(const QList<QSharedPointer<QObject>> &objects)
 // ********************************************************************** */
 {
-} // Builder::~Builder()
+    QList<LifecycleHook *> *hooks = _hooks.loadAcquire();
+    if (!hooks)
+        return;
+
+    for (LifecycleHook *hook : *hooks)
+        hook->objectsCreated(this, objects);
+} // void Builder::deliverCreated(const QList<QSharedPointer<QObject>> &objects)
 
 // ********************************************************************** */
-QSharedPointer<Configuration> Builder::configuration()
+void Builder::notifyCreated(const QSharedPointer<QObject> &object)
 // ********************************************************************** */
 {
-    return _configuration;
-} // QSharedPointer<Configuration> Builder::configuration()
+    if (!_hooks.loadAcquire())
+        return;
+
+    // Delivery waits until the outermost batch on this thread is closed
+    CreatedObject created = { this, object };
+    createdObjects.append(created);
+} // void Builder::notifyCreated(const QSharedPointer<QObject> &object)
 
 // ********************************************************************** */
-QSharedPointer<QObject> Builder::get(const char *name)
+void Builder::notifyDestroying(QObject *object)
 // ********************************************************************** */
 {
-    QByteArray objectName;
+    QList<LifecycleHook *> *hooks = _hooks.loadAcquire();
+    if (!hooks)
+        return;
 
-    // If a Configuration is set, use it to map the name
-    if (_configuration)
+    for (LifecycleHook *hook : *hooks)
+        hook->objectDestroying(this, object);
+} // void Builder::notifyDestroying(QObject *object)
+
+// ********************************************************************** */
+void Builder::noteDependency(const char *name)
+// ********************************************************************** */
+{
+    if (constructions.isEmpty())
+        return;
+
+    // Objects being constructed by other Builders are of no interest
+    const Construction &current = constructions.last();
+    if (current.builder != this)
+        return;
+
+    QMutexLocker lock(&_dependenciesMutex);
+    Q_UNUSED(lock);
+    _dependencies[current.instance->_name].insert(name);
+} // void Builder::noteDependency(const char *name)
+
+// ********************************************************************** */
+int Builder::prewarm(const QList<QByteArray> &names, int threads)
+// ********************************************************************** */
+{
+    // Find everything the given names are known to depend on, directly or
+    // indirectly
+    QHash<QByteArray, QList<QByteArray>> graph;
+    QList<QByteArray> pending = names;
+    while (!pending.isEmpty())
     {
-        QByteArray key = _section.toUtf8() + "/" + name;
-        objectName = _configuration->get(key).toByteArray();
+        QByteArray name = pending.takeLast();
+        if (graph.contains(name))
+            continue;
+
+        QList<QByteArray> nameDependencies = dependencies(name.constData());
+        graph.insert(name, nameDependencies);
+        pending.append(nameDependencies);
     }
-    // If no Configuration was used or the key did not exist, use the given name
-    // as-is
-    if (objectName.isNull())
-        objectName = name;
 
-    // Get the Instance object for the object with the correct name, creating it
-    // if it doesn't exist
-    QMutexLocker instancesLock(&_instancesMutex);
-    Instance &instance = _instances[objectName];
-    instancesLock.unlock();
-    // Get the existing reference to that object, return it if there is one
-    QSharedPointer<QObject> result = instance._reference;
-    if(result){
-        return result;
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
 
+    QHash<QByteArray, QSharedPointer<QObject>> objects;
+    QMutex objectsMutex;
+
+    // Create the objects in waves. Each wave contains every object whose
+    // dependencies have all been created by previous waves; those objects do
+    // not depend on each other, so they are created in parallel.
+    QSet<QByteArray> created;
+    while (created.size() < graph.size())
+    {
+        QList<QByteArray> wave;
+        for (auto iter = graph.constBegin(); iter != graph.constEnd(); ++iter)
+        {
+            if (created.contains(iter.key()))
+                continue;
+
+            bool ready = true;
+            for (const QByteArray &dependency : iter.value())
+                ready = ready && created.contains(dependency);
+
+            if (ready)
+                wave.append(iter.key());
+        }
+
+        // If nothing is ready, the remaining objects depend on each other.
+        // Created in parallel, two objects in a cycle would each wait for the
+        // other to be constructed; create them one at a time on this thread
+        // instead, so that get() either sorts out the order or reports the
+        // circular dependency.
+        if (wave.isEmpty())
+        {
+            for (auto iter = graph.constBegin(); iter != graph.constEnd(); ++iter)
+            {
+                if (created.contains(iter.key()))
+                    continue;
+
+                PrewarmTask task(this, iter.key(), &objects, &objectsMutex);
+                task.run();
+                wave.append(iter.key());
+            }
+        }
+        else
+        {
+            for (const QByteArray &name : wave)
+                pool.start(new PrewarmTask(this, name, &objects, &objectsMutex));
+            pool.waitForDone();
+        }
+
+        created.unite(QSet<QByteArray>::fromList(wave));
     }
-    // No object exists--lock the reference to ensure that only one thread is
-    // creating an instance at a time
-    QMutexLocker referenceLock(&instance._referenceMutex);
-    Q_UNUSED(referenceLock);
 
-    // Another thread could have been in the process of creating an instance;
-    // check that there's still no instance
-    result = instance._reference;
-    if(result)
-        return result;
-    // Look up the QMetaObject for the object name; throw an exception if none
-    // is found
-    int metaType = QMetaType::type(objectName + '*');
-    const QMetaObject *metaObject = QMetaType::metaObjectForType(metaType);
-    if (!metaObject)
+    int prewarmed = 0;
+    for (const QByteArray &name : names)
     {
-        QString message = QString("Could not find %1 for use as %2.")
-                .arg(QString(objectName))
-                .arg(name);
-        throw BuilderException(message);
+        if (objects.contains(name))
+            prewarmed++;
     }
 
-    // Create an instance of the object; try T(Builder *) first, and then T() if
-    // that fails. Throw an exception if neither constructor works.
-    QObject *object = metaObject->newInstance(Q_ARG(Builder *, this));
-    if (!object)
+    // Keep each object alive until it is first requested, in the Builder
+    // which will hand it out. Pooled objects are never handed out twice, so
+    // they are released into their pool instead.
+    InstanceTable::Guard guard(rootInstances());
+    Q_UNUSED(guard);
+
+    for (auto iter = objects.constBegin(); iter != objects.constEnd(); ++iter)
     {
-        object = metaObject->newInstance();
-        if (!object)
-        {
-            QString message = QString("Failed to create %1 for use as %2.")
-                    .arg(QString(objectName))
-                    .arg(name);
-            throw BuilderException(message);
-        }
+        Resolution &resolution = resolve(iter.key().constData());
+        if (resolution.lifetime == InstanceTable::PooledLifetime)
+            continue;
+
+        Builder *holder = this;
+        while (holder->_parent && resolution.lifetime != InstanceTable::ScopedLifetime)
+            holder = holder->_parent;
+        const Instance *instance = holder->_parent ? &holder->_instances[resolution.instance->_name]
+                                                   : resolution.instance;
+
+        QMutexLocker lock(&holder->_prewarmedMutex);
+        Q_UNUSED(lock);
+        holder->_prewarmed.insert(instance, iter.value());
+        holder->_prewarmedCount.storeRelease(holder->_prewarmed.size());
     }
 
-    // Wrap the created object in a QSharedPointer that emits destroyingObject
-    // prior to deleting the object
-    result = QSharedPointer<QObject>(object, [this](QObject *object)
+    return prewarmed;
+} // int Builder::prewarm(const QList<QByteArray> &names, int threads)
+
+// ********************************************************************** */
+void Builder::releasePrewarmed(const Instance &instance)
+// ********************************************************************** */
+{
+    // The caller holds its own reference, so the object is not destroyed here
+    QMutexLocker lock(&_prewarmedMutex);
+    Q_UNUSED(lock);
+
+    _prewarmed.remove(&instance);
+    _prewarmedCount.storeRelease(_prewarmed.size());
+} // void Builder::releasePrewarmed(const Instance &instance)
+
+// ********************************************************************** */
+QList<BindingMetrics::Snapshot> Builder::metrics()
+// ********************************************************************** */
+{
+    // Names are resolved, and metrics kept, by the root Builder
+    if (_parent)
+        return _parent->metrics();
+
+    QList<BindingMetrics::Snapshot> snapshots;
+
+#ifdef SAFEDART_METRICS
+    InstanceTable::Guard guard(_instances);
+    Q_UNUSED(guard);
+
+    for (Instance *instance : _instances.instances())
     {
-        emit destroyingObject(object);
-        delete object;
-    });
+        BindingMetrics *metrics = instance->_metrics.loadAcquire();
+        if (!metrics)
+            continue;
 
-    // Store a reference to the object in the Instance
-    instance._reference = result;
+        BindingMetrics::Snapshot snapshot = metrics->snapshot(instance->_name);
+        if (snapshot.gets || snapshot.live)
+            snapshots.append(snapshot);
+    }
+#endif
 
-    // Emit the created() signal for the newly-created object
-    emit createdObject(result);
+    return snapshots;
+} // QList<BindingMetrics::Snapshot> Builder::metrics()
 
-    // Return the created object
-    return result;
-} // QSharedPointer<QObject> Builder::get(const char *name)
+// ********************************************************************** */
+InstancePool::Statistics Builder::poolStatistics(const char *name)
+// ********************************************************************** */
+{
+    InstanceTable::Guard guard(rootInstances());
+    Q_UNUSED(guard);
+
+    InstancePool *pool = resolve(name).instance->_pool.loadAcquire();
+    if (pool)
+        return pool->statistics();
+
+    InstancePool::Statistics statistics;
+    statistics.size = 0;
+    statistics.capacity = 0;
+    statistics.highWaterMark = 0;
+    statistics.acquisitions = 0;
+    statistics.hits = 0;
+    return statistics;
+} // InstancePool::Statistics Builder::poolStatistics(const char *name)
+
+// ********************************************************************** */
+InstanceTable::Statistics Builder::instanceStatistics()
+// ********************************************************************** */
+{
+    return _instances.statistics();
+} // InstanceTable::Statistics Builder::instanceStatistics()
 
 // ********************************************************************** */
 void Builder::provide(const char *name, QSharedPointer<QObject> object)
 // ********************************************************************** */
 {
+    // Sealed names are looked up without locks, so they must never change
+    if (!_parent && _sealed.loadAcquire())
+    {
+        QString message = QString("Cannot provide %1 to a sealed Builder.").arg(name);
+        throw BuilderException(message);
+    }
+
     QByteArray objectName = name;
 
-    // Get the Instance object for the object with the correct name, creating it
-    // if it doesn't exist
-    QMutexLocker instancesLock(&_instancesMutex);
-    Instance &instance = _instances[objectName];
-    instancesLock.unlock();
+    InstanceTable::Guard guard(_instances);
+    Q_UNUSED(guard);
 
-    // Set the reference in the Instance
-    QMutexLocker referenceLock(&instance._referenceMutex);
-    Q_UNUSED(referenceLock);
-    instance._reference = object;
+    forever
+    {
+        // Get the Instance object for the object with the correct name,
+        // creating it if it doesn't exist
+        Instance &instance = _instances[objectName];
+
+        // Set the reference in the Instance, unless it has been reclaimed in
+        // the meantime; in that case, look it up again
+        QMutexLocker referenceLock(&instance._referenceMutex);
+        Q_UNUSED(referenceLock);
+        if (instance._reclaimed.loadAcquire())
+            continue;
+
+        instance._reference = object;
+        break;
+    }
+
+    // Collections built by getMulti() may hold the object which was replaced
+    Builder *root = this;
+    while (root->_parent)
+        root = root->_parent;
+    root->_provisions.ref();
 } // void Builder::provide(const char *name, QSharedPointer<QObject> object)
 
+// ********************************************************************** */
+int Builder::reclaim()
+// ********************************************************************** */
+{
+    // Scopes free their Instances all at once when they are destroyed, and a
+    // sealed table refers to its Instances for as long as the Builder exists.
+    // A thread which is in the middle of a get would wait for itself below.
+    if (_parent || _sealed.loadAcquire() || InstanceTable::Guard::isHeld())
+        return 0;
+
+    QList<Instance *> unlinked;
+    {
+        // Hold off publishing Resolutions, so that nothing can come to resolve
+        // to an Instance after it has been checked
+        QMutexLocker resolutionsLock(&_resolutionsMutex);
+        Q_UNUSED(resolutionsLock);
+
+        // A seal() which has begun may already be collecting Resolutions
+        if (_sealing)
+            return 0;
+
+        // Resolutions refer directly to the Instances that names resolve to,
+        // so those Instances are kept for as long as the Resolutions are
+        QSet<Instance *> targets;
+        for (Instance *instance : _instances.instances())
+        {
+            Resolution *resolution = instance->_resolution.loadAcquire();
+            if (resolution && resolution->instance != instance)
+                targets.insert(resolution->instance);
+        }
+        for (Resolution *resolution : _retiredResolutions)
+        {
+            if (resolution->instance != resolution->requested)
+                targets.insert(resolution->instance);
+        }
+
+        unlinked = _instances.unlink([&targets](Instance &instance)
+        {
+            if (targets.contains(&instance))
+                return false;
+
+            // Skip Instances whose objects are being created, rather than
+            // waiting for them
+            if (!instance._referenceMutex.tryLock())
+                return false;
+
+            bool reclaimable = instance._reference.isNull();
+            if (reclaimable)
+            {
+                // Mark the Instance before checking for anything that refers to
+                // it; whatever adds such a reference checks the mark afterward
+                instance._reclaimed.fetchAndStoreOrdered(1);
+
+                reclaimable = !instance._pool.loadAcquire() && instance._pin->ref.loadAcquire() == 1;
+                SAFEDART_METRIC(BindingMetrics *metrics = instance._metrics.loadAcquire());
+                SAFEDART_METRIC(reclaimable = reclaimable && (!metrics || metrics->live.loadAcquire() == 0));
+                if (!reclaimable)
+                    instance._reclaimed.storeRelease(0);
+            }
+
+            instance._referenceMutex.unlock();
+            return reclaimable;
+        });
+    }
+
+    if (unlinked.isEmpty())
+        return 0;
+
+    // Wait until no thread can still be using the unlinked Instances
+    _instances.synchronize();
+
+    {
+        QMutexLocker resolutionsLock(&_resolutionsMutex);
+        Q_UNUSED(resolutionsLock);
+
+        // Nothing can refer to the Resolutions retired from the unlinked
+        // Instances any longer
+        QSet<Instance *> reclaimed = QSet<Instance *>::fromList(unlinked);
+        auto iter = _retiredResolutions.begin();
+        while (iter != _retiredResolutions.end())
+        {
+            if (reclaimed.contains((*iter)->requested))
+            {
+                delete *iter;
+                iter = _retiredResolutions.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
+    qDeleteAll(unlinked);
+    return unlinked.size();
+} // int Builder::reclaim()
+
+// ********************************************************************** */
+void Builder::removeLifecycleHook(LifecycleHook *hook)
+// ********************************************************************** */
+{
+    QMutexLocker lock(&_hooksMutex);
+    Q_UNUSED(lock);
+
+    QList<LifecycleHook *> *hooks = _hooks.loadAcquire();
+    if (!hooks || !hooks->contains(hook))
+        return;
+
+    // With no hooks left, go back to doing no work for them at all
+    QList<LifecycleHook *> *replacement = new QList<LifecycleHook *>(*hooks);
+    replacement->removeAll(hook);
+    if (replacement->isEmpty())
+    {
+        delete replacement;
+        replacement = nullptr;
+    }
+
+    _hooks.storeRelease(replacement);
+    _retiredHooks.append(hooks);
+} // void Builder::removeLifecycleHook(LifecycleHook *hook)
+
+// ********************************************************************** */
+void Builder::seal(const QList<QByteArray> &names)
+// ********************************************************************** */
+{
+    // Scopes resolve names through their parent
+    if (_parent || _sealed.loadAcquire())
+        return;
+
+    // Stop reclaim() from unlinking Instances from now on. One which is already
+    // under way finishes unlinking first, so the names collected below only
+    // include Instances it has left in the table.
+    {
+        QMutexLocker resolutionsLock(&_resolutionsMutex);
+        Q_UNUSED(resolutionsLock);
+        _sealing = true;
+    }
+
+    InstanceTable::Guard guard(_instances);
+    Q_UNUSED(guard);
+
+    // Seal every name requested so far, along with the given names
+    QSet<QByteArray> nameSet = QSet<QByteArray>::fromList(names);
+    for (Instance *instance : _instances.instances())
+    {
+        if (instance->_resolution.loadAcquire())
+            nameSet.insert(instance->_name);
+    }
+    QList<QByteArray> sealedNames = nameSet.toList();
+
+    // Resolve them all under a single stamp, trying again if the configuration
+    // changes in the meantime. The stamp is taken from the resolutions
+    // themselves, since a Configuration without revisions never reports the
+    // same stamp twice.
+    quint64 stamp;
+    QVector<Resolution *> resolutions;
+    forever
+    {
+        resolutions = resolve(sealedNames);
+        stamp = resolutions.isEmpty() ? resolutionStamp() : resolutions.first()->stamp.loadAcquire();
+
+        bool current = true;
+        for (Resolution *resolution : resolutions)
+            current = current && resolution->stamp.loadAcquire() == stamp;
+        if (current)
+            break;
+    }
+
+    // Work out how each type is constructed now, rather than on first use.
+    // Names without a type may be provided later, so are not an error here.
+    for (Resolution *resolution : resolutions)
+    {
+        if (findMetaObject(*resolution->instance))
+            constructionPlan(resolution->requested->_name.constData(), *resolution->instance);
+    }
+
+    SealedTable *sealed = new SealedTable(resolutions, stamp);
+    if (!_sealed.testAndSetOrdered(nullptr, sealed))
+        delete sealed;
+} // void Builder::seal(const QList<QByteArray> &names)
+
+// ********************************************************************** */
+bool Builder::isSealed()
+// ********************************************************************** */
+{
+    if (_parent)
+        return _parent->isSealed();
+
+    return _sealed.loadAcquire() != nullptr;
+} // bool Builder::isSealed()
+
+// ********************************************************************** */
+Builder::Resolution &Builder::resolve(const char *name)
+// ********************************************************************** */
+{
+    // Scopes always resolve names the same way as their parents
+    if (_parent)
+        return _parent->resolve(name);
+
+    // Sealed names are looked up without taking any lock
+    int size = int(qstrlen(name));
+    SealedTable *sealed = _sealed.loadAcquire();
+    if (sealed)
+    {
+        Resolution *resolution = sealed->find(name, size);
+        if (resolution)
+            return *resolution;
+    }
+
+    // Get the Instance for the requested name without copying the name
+    QByteArray requestedName = QByteArray::fromRawData(name, size);
+    return resolveInstance(_instances[requestedName]);
+} // Builder::Resolution &Builder::resolve(const char *name)
+
+// ********************************************************************** */
+Builder::Resolution &Builder::resolve(const Atom &name)
+// ********************************************************************** */
+{
+    // Scopes always resolve names the same way as their parents
+    if (_parent)
+        return _parent->resolve(name);
+
+    SealedTable *sealed = _sealed.loadAcquire();
+    if (sealed)
+    {
+        Resolution *resolution = sealed->find(name);
+        if (resolution)
+            return *resolution;
+    }
+
+    return resolveInstance(_instances[name]);
+} // Builder::Resolution &Builder::resolve(const Atom &name)
+
+// ********************************************************************** */
+Builder::Resolution &Builder::resolveInstance(Instance &requested)
+// ********************************************************************** */
+{
+    // If the name was already resolved under the current configuration, reuse
+    // the result. The stamp must be read before the Configuration, so that a
+    // concurrent change can only make the stored result look stale.
+    quint64 stamp = resolutionStamp();
+    Resolution *resolution = requested._resolution.loadAcquire();
+    if (resolution && resolution->stamp.loadAcquire() == stamp)
+        return *resolution;
+
+    QVector<Instance *> stale(1, &requested);
+    return *publishResolutions(stale, stamp).first();
+} // Builder::Resolution &Builder::resolveInstance(Instance &requested)
+
+// ********************************************************************** */
+QVector<Builder::Resolution *> Builder::resolve(const QList<QByteArray> &names)
+// ********************************************************************** */
+{
+    // Scopes always resolve names the same way as their parents
+    if (_parent)
+        return _parent->resolve(names);
+
+    // Reuse every result that is still current, reading the stamp only once
+    quint64 stamp = resolutionStamp();
+    SealedTable *sealed = _sealed.loadAcquire();
+    QVector<Resolution *> resolutions(names.size());
+    QVector<Instance *> stale;
+    QVector<int> staleIndices;
+    for (int i = 0; i < names.size(); i++)
+    {
+        if (sealed)
+        {
+            resolutions[i] = sealed->find(names.at(i).constData(), names.at(i).size());
+            if (resolutions.at(i))
+                continue;
+        }
+
+        Instance &requested = _instances[names.at(i)];
+        Resolution *resolution = requested._resolution.loadAcquire();
+        if (resolution && resolution->stamp.loadAcquire() == stamp)
+        {
+            resolutions[i] = resolution;
+        }
+        else
+        {
+            stale.append(&requested);
+            staleIndices.append(i);
+        }
+    }
+
+    // Resolve the rest together
+    if (!stale.isEmpty())
+    {
+        QVector<Resolution *> published = publishResolutions(stale, stamp);
+        for (int i = 0; i < stale.size(); i++)
+            resolutions[staleIndices.at(i)] = published.at(i);
+    }
+
+    return resolutions;
+} // QVector<Builder::Resolution *> Builder::resolve(const QList<QByteArray> &names)
+
+// ********************************************************************** */
+QVector<Builder::Resolution *> Builder::publishResolutions(const QVector<Instance *> &requested, quint64 stamp)
+// ********************************************************************** */
+{
+    QVector<Instance *> instances = requested;
+    QVector<Lifetime> lifetimes(requested.size(), InstanceTable::SharedLifetime);
+
+    // If a Configuration is set, use it to map each name and find its lifetime.
+    // If no Configuration was used or a key did not exist, the requested name
+    // is used as-is.
+    if (_configuration)
+    {
+        QByteArray prefix = _section.toUtf8() + "/";
+        QStringList scoped = _configuration->get(prefix + "@scoped").toStringList();
+        QStringList pooled = _configuration->get(prefix + "@pooled").toStringList();
+
+        for (int i = 0; i < requested.size(); i++)
+        {
+            QByteArray objectName = _configuration->get(prefix + requested.at(i)->_name).toByteArray();
+            if (!objectName.isNull())
+                instances[i] = &_instances[objectName];
+
+            QString requestedName = QString::fromUtf8(requested.at(i)->_name);
+            if (scoped.contains(requestedName))
+                lifetimes[i] = InstanceTable::ScopedLifetime;
+            else if (pooled.contains(requestedName))
+                lifetimes[i] = InstanceTable::PooledLifetime;
+        }
+    }
+
+    // Publish the results. Readers never lock, so a Resolution which is
+    // replaced is kept until the Builder is destroyed rather than deleted; a
+    // new one is only needed when the name maps to a different Instance.
+    QVector<Resolution *> resolutions(requested.size());
+
+    QMutexLocker resolutionsLock(&_resolutionsMutex);
+    Q_UNUSED(resolutionsLock);
+
+    for (int i = 0; i < requested.size(); i++)
+    {
+        // The Instance resolved to may have been reclaimed since it was looked
+        // up. reclaim() holds the same lock, so once published, it is safe.
+        if (instances.at(i)->_reclaimed.loadAcquire())
+            instances[i] = &_instances[instances.at(i)->_name];
+
+        Resolution *resolution = requested.at(i)->_resolution.loadAcquire();
+        if (resolution && resolution->instance == instances.at(i) && resolution->lifetime == lifetimes.at(i))
+        {
+            resolution->stamp.storeRelease(stamp);
+            resolutions[i] = resolution;
+            continue;
+        }
+
+        Resolution *replacement = new Resolution;
+        replacement->instance = instances.at(i);
+        replacement->requested = requested.at(i);
+        replacement->lifetime = lifetimes.at(i);
+        replacement->stamp.storeRelease(stamp);
+        requested.at(i)->_resolution.storeRelease(replacement);
+        resolutions[i] = replacement;
+
+        if (resolution)
+            _retiredResolutions.append(resolution);
+    }
+
+    return resolutions;
+} // QVector<Builder::Resolution *> Builder::publishResolutions(const QVector<Instance *> &requested, quint64 stamp)
+
+// ********************************************************************** */
+quint64 Builder::resolutionStamp()
+// ********************************************************************** */
+{
+    if (_parent)
+        return _parent->resolutionStamp();
+
+    SealedTable *sealed = _sealed.loadAcquire();
+    if (sealed)
+        return sealed->stamp();
+
+    quint64 stamp = quint64(quint32(_generation.loadAcquire())) << 32;
+    if (_configuration)
+        stamp |= quint32(_configuration->revision());
+
+    return stamp;
+} // quint64 Builder::resolutionStamp()
+
+// ********************************************************************** */
+Builder::Resolution *Builder::pinResolution(const char *name, QExplicitlySharedDataPointer<InstanceTable::Pin> &pin)
+// ********************************************************************** */
+{
+    InstanceTable::Guard guard(rootInstances());
+    Q_UNUSED(guard);
+
+    // reclaim() marks an Instance before checking whether it is pinned; if it
+    // was marked before the Pin was taken, look the name up again
+    forever
+    {
+        Resolution &resolution = resolve(name);
+        QExplicitlySharedDataPointer<InstanceTable::Pin> requestedPin = resolution.requested->_pin;
+        if (!resolution.requested->_reclaimed.loadAcquire())
+        {
+            pin = requestedPin;
+            return &resolution;
+        }
+    }
+} // Builder::Resolution *Builder::pinResolution(const char *name, QExplicitlySharedDataPointer<InstanceTable::Pin> &pin)
+
+// ********************************************************************** */
+InstanceTable &Builder::rootInstances()
+// ********************************************************************** */
+{
+    return _parent ? _parent->rootInstances() : _instances;
+} // InstanceTable &Builder::rootInstances()
+
 // ********************************************************************** */
 QString Builder::section()
 // ********************************************************************** */
 {
+    if (_parent)
+        return _parent->section();
+
     return _section;
 } // QString Builder::section()
 
@@ -174,13 +2054,18 @@ QString Builder::section()
 void Builder::setConfiguration(QSharedPointer<Configuration> configuration, const QString &section)
 // ********************************************************************** */
 {
+    // Scopes always use their parent's configuration
+    if (_parent)
+        return;
+
+    if (_sealed.loadAcquire())
+        throw BuilderException(QString("Cannot change the configuration of a sealed Builder."));
+
+    // Names only need to be resolved again if something actually changed
+    if (configuration == _configuration && section == _section)
+        return;
+
     _configuration = configuration;
     _section = section;
+    _generation.ref();
 } // void Builder::setConfiguration(QSharedPointer<Configuration> configuration, const QString &section)
-
-// ********************************************************************** */
-Builder::Instance::Instance(const Instance &copy) :
-  _reference(copy._reference)
-// ********************************************************************** */
-{
-} // Builder::Instance::Instance(const Instance &copy)
@@ -33,14 +33,33 @@
 ********************************************************************** */
 #pragma once
 
+#include <QAtomicInt>
+#include <QAtomicPointer>
 #include <QByteArray>
 #include <QException>
+#include <QExplicitlySharedDataPointer>
+#include <QFuture>
+#include <QFutureInterface>
 #include <QHash>
+#include <QList>
+#include <QMetaMethod>
 #include <QMutex>
 #include <QObject>
+#include <QReadWriteLock>
+#include <QScopedPointer>
+#include <QSet>
 #include <QSharedPointer>
+#include <QThreadPool>
+#include <QVector>
+#include <QWeakPointer>
 
+#include <functional>
+#include <tuple>
+
+#include <atom.h>
 #include <configuration.h>
+#include <instancetable.h>
+#include <lifecyclehook.h>
 
 /*!
  * \brief An exception thrown when creation of a class fails.
@@ -106,6 +125,20 @@ protected:
     const QByteArray _message;
 };
 
+template<typename T>
+class Factory;
+
+template<typename T>
+class GetResult;
+
+template<typename T>
+class Lazy;
+
+template<typename T>
+class ServiceHandle;
+
+class SealedTable;
+
 /*!
  * \brief Builds and caches objects created through reflection.
  *
@@ -141,6 +174,55 @@ public:
     explicit Builder(QObject *parent = 0);
     ~Builder();
 
+    /*!
+     * \brief The number of idle objects kept for each pooled name, unless the
+     * configuration says otherwise.
+     */
+    static const int DefaultPoolCapacity = 16;
+
+    /*!
+     * \brief The objectName of the child QObject which keeps the objects
+     * injected into a constructor as <tt>I *</tt> alive.
+     *
+     * An object constructed with any <tt>I *</tt> arguments is given one such
+     * child, which holds a reference to each of those objects until it is
+     * destroyed along with its parent. It shows up in QObject::children() and
+     * QObject::findChildren(); deleting it releases the injected objects while
+     * the object may still use them.
+     */
+    static const char InjectedObjectsName[];
+
+    /*!
+     * \brief The reasons tryGet() can fail to get an object.
+     */
+    enum GetError
+    {
+        /*!
+         * \brief The object was gotten.
+         */
+        NoError,
+
+        /*!
+         * \brief No QObject could be found with the resolved name.
+         */
+        NotFoundError,
+
+        /*!
+         * \brief The QObject was found, but could not be created.
+         */
+        NotCreatedError,
+
+        /*!
+         * \brief The object could not be cast to the requested type.
+         */
+        WrongTypeError
+    };
+
+    /*!
+     * \brief An immutable collection of objects, as returned by getMulti().
+     */
+    typedef QSharedPointer<const QList<QSharedPointer<QObject>>> Collection;
+
     /*!
      * \brief Gets an instance of a generic object by name.
      *
@@ -151,13 +233,18 @@ public:
      * configuration file has Foo=Bar and Bar=Baz, get("Foo") will attempt to
      * create an instance of the class named Bar.
      *
+     * The result of looking up a name is cached, and the Configuration is only
+     * consulted again once it has been changed (see Configuration::revision())
+     * or replaced through setConfiguration().
+     *
      * If the given type has been instantiated before, the existing object will
      * be returned if it still exists. This is true <i>even if the given name is
      * different</i>; for instance, if the configuration file has Foo=Baz and
      * Bar=Baz, get("Foo") and get("Bar") may return the same object.
      *
-     * Once found, the QObject in question will be instantiated; T(Builder *) is
-     * used if it is available, else T() is used.
+     * Once found, the QObject in question will be instantiated; its injected
+     * constructor (see SAFEDART_DECLARE_INJECTABLE()) is used if it has one,
+     * else T(Builder *) if it is available, else T().
      *
      * \param name The name of the type to instantiate.
      *
@@ -172,6 +259,23 @@ public:
      */
     virtual QSharedPointer<QObject> get(const char *name);
 
+    /*!
+     * \brief Gets an instance of a generic object by its interned name.
+     *
+     * Functions identically to get(const char *), but the name is neither
+     * measured nor hashed again, and is compared with the names the Builder
+     * already knows by address where possible. This suits names which are
+     * requested repeatedly, such as from a hot loop: intern the name once, and
+     * pass the Atom on every call.
+     *
+     * \param name The name of the type to instantiate.
+     *
+     * \return An instance of the object type associated with the given name.
+     *
+     * \see get(const char *)
+     */
+    virtual QSharedPointer<QObject> get(const Atom &name);
+
     /*!
      * \brief Gets an instance of a specific type by name.
      *
@@ -184,6 +288,18 @@ public:
     template<typename T>
     QSharedPointer<T> get(const char *name);
 
+    /*!
+     * \brief Gets an instance of a specific type by its interned name.
+     *
+     * Functions very similarly to get(const Atom &), but additionally casts the
+     * object (safely) to the given type.
+     *
+     * \see get(const Atom &)
+     * \throw BuilderException The object could not be cast to type T.
+     */
+    template<typename T>
+    QSharedPointer<T> get(const Atom &name);
+
     /*!
      * \brief Gets an instance of a specific type.
      *
@@ -199,161 +315,1331 @@ public:
     QSharedPointer<T> get();
 
     /*!
-     * \brief Provides an instance of QObject to be associated with the given
-     * name.
+     * \brief Gets an instance of a generic object by name, without throwing.
      *
-     * This allows a custom object to be provided, which will be returned when
-     * the object with the given name is requested.
+     * Functions very similarly to get(const char *), but reports failure
+     * through its result. Names whose type could not be found are remembered,
+     * and are not looked for again until more types may have been added (see
+     * FactoryRegistry::typesAdded()), so probing repeatedly for an optional
+     * object which does not exist is cheap.
      *
-     * \param name The name to associate the given object with.
-     * \param object The object to associate with the given name.
+     * \param name The name of the type to instantiate.
      *
-     * \note Builder holds only a weak pointer to \c object; it must be kept
-     * alive by the caller, or it will be freed and default rules will be used
-     * to instantiate the object when requested.
+     * \return The object, or the reason it could not be gotten.
+     *
+     * \see get(const char *)
+     *
+     * \note Exceptions other than BuilderException, such as those thrown by
+     * constructors themselves, are not caught.
      */
-    virtual void provide(const char *name, QSharedPointer<QObject> object);
+    GetResult<QObject> tryGet(const char *name);
 
     /*!
-     * \brief Gets the Configuration used by this Builder.
+     * \brief Gets an instance of a specific type by name, without throwing.
      *
-     * \return A pointer to the Configuration used by this Builder. May be null
-     * if none was set.
+     * Functions very similarly to tryGet(const char *), but casts the object
+     * to type T.
+     *
+     * \param name The name of the type to instantiate.
+     *
+     * \return The object, or the reason it could not be gotten.
+     *
+     * \see tryGet(const char *)
      */
-    QSharedPointer<Configuration> configuration();
+    template<typename T>
+    GetResult<T> tryGet(const char *name);
 
     /*!
-     * \brief Gets the configuration section used by this Builder.
+     * \brief Gets an instance of a specific type, without throwing.
+     *
+     * Functions very similarly to tryGet<T>(const char *), but uses the name
+     * of the interface T.
      *
-     * \return The configuration section used by this builder.
+     * \see tryGet<T>(const char *)
+     *
+     * \note T must have been declared as an interface using Q_DECLARE_INTERFACE
+     * for this to work correctly.
      */
-    QString section();
+    template<typename T>
+    GetResult<T> tryGet();
 
     /*!
-     * \brief Sets the Configuration used by this Builder.
+     * \brief Gets an instance of a generic object by name, without blocking.
      *
-     * \param configuration The Configuration to be used by this Builder.
-     * \param section The section within the configuration file to use.
+     * If the object already exists, the returned future has already finished.
+     * Otherwise, the object is gotten through get(const char *) on a thread
+     * from \c pool, and the future finishes once it has been created. If
+     * several threads ask for the same object while it is being created, they
+     * all wait on the same construction, which takes up a single thread of the
+     * pool; only objects with a pooled lifetime are constructed separately for
+     * each request.
+     *
+     * \param name The name of the type to instantiate.
+     * \param pool The thread pool on which to create the object, or null to use
+     * QThreadPool::globalInstance().
+     *
+     * \return A future for the instance of the object type associated with the
+     * given name. If the object cannot be found or created, the future reports
+     * a BuilderException, which QFuture::result() rethrows.
+     *
+     * \warning The Builder must not be destroyed while a get is in progress.
+     *
+     * \see get(const char *)
      */
-    void setConfiguration(QSharedPointer<Configuration> configuration, const QString &section = "safedart");
+    QFuture<QSharedPointer<QObject>> getAsync(const char *name, QThreadPool *pool = nullptr);
 
-signals:
     /*!
-     * \brief Emitted when an object is created by the Builder.
+     * \brief Gets an instance of a specific type by name, without blocking.
      *
-     * This signal is provided so that the application may perform additional
-     * logic for newly-created objects. This signal is emitted after the object
-     * is instantiated, but before get() returns the object to the caller.
+     * Functions very similarly to getAsync(const char *, QThreadPool *), but
+     * additionally casts the object (safely) to the given type. If the cast
+     * fails, the future reports a BuilderException.
      *
-     * \param object A pointer to the object that was created.
+     * \see getAsync(const char *, QThreadPool *)
      */
-    void createdObject(QSharedPointer<QObject> object);
+    template<typename T>
+    QFuture<QSharedPointer<T>> getAsync(const char *name, QThreadPool *pool = nullptr);
 
     /*!
-     * \brief Emitted when an object is about to be destroyed by the Builder.
+     * \brief Gets an instance of a specific type, without blocking.
      *
-     * This signal is provided so that the application may perform additional
-     * logic for an object immediately before it is destroyed. This signal is
-     * emitted immediately before the object is deleted, so the pointer that is
-     * passed in should not be kept.
+     * Functions very similarly to getAsync<T>(const char *, QThreadPool *), but
+     * uses the name of the interface T.
      *
-     * \param object A pointer to the object that will be destroyed.
+     * \see getAsync<T>(const char *, QThreadPool *)
      *
-     * \warning If this signal is connected in a queued non-blocking fashion,
-     * the object pointer may be invalid by the time the slot is executed. Be
-     * aware that <b>this can happen if automatic connection is used</b>.
+     * \note T must have been declared as an interface using Q_DECLARE_INTERFACE
+     * for this to work correctly.
      */
-    void destroyingObject(QObject *object);
+    template<typename T>
+    QFuture<QSharedPointer<T>> getAsync(QThreadPool *pool = nullptr);
 
-protected:
     /*!
-     * \brief A previously-created instance of an object.
+     * \brief Gets instances of several generic objects by name, in one pass.
+     *
+     * Equivalent to calling get(const char *) for each name in turn, but
+     * cheaper: all names are resolved together, so the configuration stamp is
+     * read once and the Configuration is consulted once for whatever names are
+     * not already resolved. This is intended for T(Builder *) constructors
+     * which need several objects at once.
      *
-     * The Instance struct contains the necessary information to maintain a
-     * reference to a shared object while it exists, without preventing it from
-     * being deleted. It also allows creation of the object to be synchronized
-     * to ensure that only one instance of the object exists at a time.
+     * \param names The names of the types to instantiate.
      *
-     * \note QWeakPointer itself is thread-safe, so exclusive access is not
-     * required to be able to access an existing instance of the object. If
-     * there is no existing instance of the object, however, only one should be
-     * created. In this case, a lock is used, so that only one thread will
-     * attempt to create an object. This ensures that only one instance of the
-     * object will exist at any given time.
+     * \return Instances of the object types associated with the given names, in
+     * the same order as the names.
+     *
+     * \throw BuilderException Any of the objects could not be found or created.
+     *
+     * \see get(const char *)
      */
-    struct Instance
-    {
-        /*!
-         * \brief A mutex which synchronizes the creation of the instance stored
-         * in \c _reference.
-         *
-         * No lock is needed be used when reading the value of the pointer, but
-         * a lock should be held when creating the object. To ensure proper
-         * synchronization, \c _reference should be checked again after locking
-         * the mutex and before creating an instance of the object.
-         */
-        QMutex _referenceMutex;
+    QList<QSharedPointer<QObject>> getAll(const QList<QByteArray> &names);
 
-        /*!
-         * \brief A weak pointer to the existing instance of the object, if any.
-         */
-        QWeakPointer<QObject> _reference;
+    /*!
+     * \brief Gets instances of several specific types, in one pass.
+     *
+     * Functions very similarly to getAll(const QList<QByteArray> &), but uses
+     * the names of the interfaces T and casts each object to its interface.
+     * For instance:
+     *
+     * \code
+     * QSharedPointer<Greeter> greeter;
+     * QSharedPointer<ModuleLoader> loader;
+     * std::tie(greeter, loader) = builder->getAll<Greeter, ModuleLoader>();
+     * \endcode
+     *
+     * \see getAll(const QList<QByteArray> &)
+     * \throw BuilderException Any of the objects could not be cast to its type.
+     *
+     * \note Each T must have been declared as an interface using
+     * Q_DECLARE_INTERFACE for this to work correctly.
+     */
+    template<typename... T>
+    std::tuple<QSharedPointer<T>...> getAll();
 
-        /*!
-         * \brief Creates an Instance containing no value.
-         */
-        Instance() = default;
+    /*!
+     * \brief Gets every object bound to a name.
+     *
+     * A name may be bound to a list of types in the Configuration, such as
+     * <tt>Handler=FirstHandler, SecondHandler</tt>. A name bound to a single
+     * type is treated as a list of one, and a name which is not in the
+     * Configuration as a list of itself. The types in the list are then gotten
+     * together, as if by getAll(const QList<QByteArray> &), except that they
+     * are not mapped through the Configuration again: with
+     * <tt>FirstHandler=Other</tt> also configured, the list still yields a
+     * FirstHandler.
+     *
+     * The collection is cached, and the same collection is returned for as
+     * long as any caller holds it. It is only built again once the binding
+     * changes, an object is provided to the Builder, or one of its objects
+     * has expired.
+     *
+     * \param name The name whose objects to get.
+     *
+     * \return The objects bound to the name, in the order they are listed.
+     *
+     * \throw BuilderException Any of the objects could not be found or created.
+     */
+    Collection getMulti(const char *name);
 
-        /*!
-         * \brief Creates a copy of the given Instance.
-         *
-         * \param copy The Instance whose reference to copy.
-         */
-        Instance(const Instance &copy);
-    };
+    /*!
+     * \brief Gets every object bound to a name, cast to a specific type.
+     *
+     * Functions very similarly to getMulti(const char *), but casts each
+     * object to T. The cast list is not cached.
+     *
+     * \param name The name whose objects to get.
+     *
+     * \see getMulti(const char *)
+     * \throw BuilderException Any of the objects could not be cast to type T.
+     */
+    template<typename T>
+    QList<QSharedPointer<T>> getMulti(const char *name);
 
     /*!
-     * \brief A pointer to the Configuration used by this Builder.
+     * \brief Gets every object bound to the name of interface T, cast to T.
+     *
+     * \see getMulti(const char *)
+     * \throw BuilderException Any of the objects could not be cast to type T.
+     *
+     * \note T must have been declared as an interface using Q_DECLARE_INTERFACE
+     * for this to work correctly.
      */
-    QSharedPointer<Configuration> _configuration;
+    template<typename T>
+    QList<QSharedPointer<T>> getMulti();
 
     /*!
-     * \brief A mapping of object name to the existing instance (if any).
+     * \brief Gets a handle through which instances of a specific type may be
+     * gotten repeatedly by name.
+     *
+     * A ServiceHandle remembers the Instance which the name resolved to and the
+     * result of casting the object to T, so getting the object through the
+     * handle is much cheaper than calling get<T>(const char *) each time. The
+     * handle follows changes to the configuration and to the object itself, so
+     * it always returns the same object that get<T>(const char *) would.
+     *
+     * No object is created until ServiceHandle::get() is first called.
+     *
+     * \param name The name of the type to instantiate.
+     *
+     * \return A handle for the object type associated with the given name.
+     *
+     * \see ServiceHandle
      */
-    QHash<QByteArray, Instance> _instances;
+    template<typename T>
+    ServiceHandle<T> handle(const char *name);
 
     /*!
-     * \brief A mutex used to ensure that access to \c _instances is exclusive.
+     * \brief Gets a handle through which instances of a specific type may be
+     * gotten repeatedly.
+     *
+     * Functions very similarly to handle<T>(const char *), but uses the name of
+     * the interface T.
+     *
+     * \see handle<T>(const char *)
      *
-     * Because it is not known whether an object exists in the map prior to
-     * looking it up, an exclusive lock is used. This allows the index operator
-     * to be used, which will add the key if it does not already exist in a
-     * single operation.
+     * \note T must have been declared as an interface using Q_DECLARE_INTERFACE
+     * for this to work correctly.
      */
-    QMutex _instancesMutex;
+    template<typename T>
+    ServiceHandle<T> handle();
 
     /*!
-     * \brief A string containing the name of the configuration section to use.
+     * \brief Gets a Factory through which new objects of a specific type may
+     * be created repeatedly by name.
+     *
+     * A Factory resolves the name and chooses the type's constructor once, so
+     * that creating each object afterwards costs little more than constructing
+     * it directly. Unlike get<T>(const char *), every object it creates is
+     * new.
+     *
+     * \param name The name of the type to instantiate.
+     *
+     * \return A Factory for the object type associated with the given name.
+     *
+     * \see Factory
      */
-    QString _section;
-};
+    template<typename T>
+    Factory<T> factory(const char *name);
 
-template<typename T>
-QSharedPointer<T> Builder::get(const char *name)
-{
-   QSharedPointer<T> object = get(name).objectCast<T>();
+    /*!
+     * \brief Gets a Factory through which new objects of a specific type may
+     * be created repeatedly.
+     *
+     * Functions very similarly to factory<T>(const char *), but uses the name
+     * of the interface T.
+     *
+     * \see factory<T>(const char *)
+     *
+     * \note T must have been declared as an interface using Q_DECLARE_INTERFACE
+     * for this to work correctly.
+     */
+    template<typename T>
+    Factory<T> factory();
 
-   if (!object)
-   {
-        QString message = QString("Type does not implement the requested service.");
-        throw BuilderException(message);
-   }
-   return object;
-}
+    /*!
+     * \brief Gets a proxy for an instance of a specific type by name, which
+     * is only created when first used.
+     *
+     * This is intended for T(Builder *) constructors with collaborators which
+     * are only needed on rare code paths: the name is recorded, but
+     * get<T>(const char *) is not called until the proxy is first dereferenced.
+     *
+     * \param name The name of the type to instantiate.
+     *
+     * \return A proxy for the object type associated with the given name.
+     *
+     * \see Lazy
+     */
+    template<typename T>
+    Lazy<T> lazy(const char *name);
 
-template<typename T>
-QSharedPointer<T> Builder::get()
-{
-   const char *name = qobject_interface_iid<T *>();
-   return get<T>(name);
-}
+    /*!
+     * \brief Gets a proxy for an instance of a specific type, which is only
+     * created when first used.
+     *
+     * Functions very similarly to lazy<T>(const char *), but uses the name of
+     * the interface T.
+     *
+     * \see lazy<T>(const char *)
+     *
+     * \note T must have been declared as an interface using Q_DECLARE_INTERFACE
+     * for this to work correctly.
+     */
+    template<typename T>
+    Lazy<T> lazy();
+
+    /*!
+     * \brief Provides an instance of QObject to be associated with the given
+     * name.
+     *
+     * This allows a custom object to be provided, which will be returned when
+     * the object with the given name is requested.
+     *
+     * \param name The name to associate the given object with.
+     * \param object The object to associate with the given name.
+     *
+     * \note Builder holds only a weak pointer to \c object; it must be kept
+     * alive by the caller, or it will be freed and default rules will be used
+     * to instantiate the object when requested.
+     *
+     * \throw BuilderException The Builder has been sealed. Objects may still
+     * be provided to its scopes.
+     */
+    virtual void provide(const char *name, QSharedPointer<QObject> object);
+
+    /*!
+     * \brief Creates the objects for a list of names ahead of time, in
+     * parallel.
+     *
+     * Normally, each object is created the first time it is requested, so the
+     * first requests after start-up pay for creating all of the objects they
+     * use one after another. Prewarming creates them up front on a pool of
+     * threads instead.
+     *
+     * Builder learns which names depend on which by observing the names that
+     * are requested from within each object's constructor (see
+     * dependencies()). Objects whose dependencies are known are created only
+     * once all of their dependencies have been created, and objects which do
+     * not depend on each other are created in parallel. Dependencies which are
+     * not yet known are simply created on the thread which requests them.
+     * Objects which depend on each other in a cycle are created one at a time
+     * on the calling thread.
+     *
+     * Objects created by prewarming are kept alive by the Builder until they
+     * are first requested, so that they exist by then. Objects with a pooled
+     * lifetime are released into their pool straight away.
+     *
+     * \param names The names of the types to instantiate.
+     * \param threads The maximum number of threads to use. If not positive,
+     * the ideal number of threads for the system is used.
+     *
+     * \return The number of the given names which could be instantiated. Names
+     * which could not be are skipped; get() will report the error when they are
+     * requested.
+     */
+    int prewarm(const QList<QByteArray> &names, int threads = 0);
+
+    /*!
+     * \brief Gets the names which the object for the given name depends on.
+     *
+     * Objects injected into the type's constructor are known in advance. Any
+     * other names are those which the constructor has been observed to
+     * request.
+     *
+     * \param name The name of the type whose dependencies to get.
+     *
+     * \return The names injected into, or requested by, the constructor of the
+     * type the given name resolves to.
+     */
+    QList<QByteArray> dependencies(const char *name);
+
+    /*!
+     * \brief Creates a scope: a child Builder which falls back to this one.
+     *
+     * A scope is a lightweight Builder for a short-lived unit of work, such as
+     * a request, a tenant or a test. It starts out empty, and shares this
+     * Builder's Configuration, resolved names and construction plans without
+     * copying them. Getting an object from a scope works as follows:
+     *
+     * \li If an object has been provided to the scope for the resolved name
+     * (see provide()), that object is used.
+     * \li If the name's lifetime is scoped, the scope creates and keeps its own
+     * object, passing itself to the T(Builder *) constructor so that the
+     * object's own dependencies also come from the scope.
+     * \li Otherwise, the object is gotten from this Builder.
+     *
+     * A name's lifetime is scoped if it is listed in the \c \@scoped key of the
+     * configuration section.
+     *
+     * Scopes may themselves have scopes.
+     *
+     * A scope keeps the objects it creates alive until it is destroyed, at
+     * which point they are all destroyed together, in the reverse order of
+     * creation. The scope's own bookkeeping is allocated from an Arena, and
+     * released in a few large blocks rather than piece by piece.
+     *
+     * \return A new scope of this Builder.
+     *
+     * \warning A scope must not outlive the Builder it was created from.
+     */
+    QSharedPointer<Builder> createScope();
+
+    /*!
+     * \brief Installs a hook which is notified about the objects this Builder
+     * creates and destroys.
+     *
+     * While no hooks are installed, the Builder does no work on their behalf.
+     * The createdObject() and destroyingObject() signals are themselves
+     * delivered through a hook, which is installed the first time either
+     * signal is connected.
+     *
+     * \param hook The hook to install. The Builder does not take ownership; the
+     * hook must be removed or outlive the Builder.
+     *
+     * \note Hooks installed on a Builder are not notified about objects created
+     * by its scopes.
+     *
+     * \see LifecycleHook
+     */
+    void addLifecycleHook(LifecycleHook *hook);
+
+    /*!
+     * \brief Removes a hook installed through addLifecycleHook().
+     *
+     * \param hook The hook to remove.
+     *
+     * \note A thread which is already notifying the hook may continue to do so
+     * briefly after this returns.
+     */
+    void removeLifecycleHook(LifecycleHook *hook);
+
+    /*!
+     * \brief Gets metrics describing how each name has been gotten.
+     *
+     * Metrics are only collected if SAFE-DART was built with them enabled (see
+     * SAFEDART_METRIC); otherwise, this returns an empty list. Gets are counted
+     * under the name that was requested, so a name which is mapped to another
+     * through the Configuration has metrics of its own. Scopes report their
+     * root Builder's metrics.
+     *
+     * \return A snapshot of the metrics of each name which has been gotten, or
+     * which has objects that still exist.
+     */
+    QList<BindingMetrics::Snapshot> metrics();
+
+    /*!
+     * \brief Gets statistics about the pool used for the given name.
+     *
+     * A name's lifetime is pooled if it is listed in the \c \@pooled key of the
+     * configuration section. Each get of a pooled name returns an object of
+     * its own; once released, the object is reset and kept for reuse, up to
+     * the number given by the name's own \c \@pool_size key (for example
+     * \c safedart/Name/\@pool_size), or else by the section's \c \@pool_size
+     * key (DefaultPoolCapacity if neither is set). See InstancePool for how
+     * objects are reset.
+     *
+     * \param name The name whose pool to examine.
+     *
+     * \return The statistics of the pool which the name resolves to. All zero
+     * if no pooled object has been gotten for the name.
+     */
+    InstancePool::Statistics poolStatistics(const char *name);
+
+    /*!
+     * \brief Gets statistics about the table of names known to this Builder.
+     *
+     * \return The number of names in the table, and how many have been removed
+     * by reclaim().
+     */
+    InstanceTable::Statistics instanceStatistics();
+
+    /*!
+     * \brief Removes names whose objects no longer exist from the Builder.
+     *
+     * Every name that is requested or provided is remembered, along with how it
+     * resolves, how its objects are constructed and (if enabled) its metrics.
+     * A Builder which is asked for many short-lived names therefore grows
+     * without bound unless this is called from time to time, such as from a
+     * timer.
+     *
+     * A name is removed only if no object for it exists, and it is not in use
+     * in any way: nothing else resolves to it, it is not pooled, no
+     * ServiceHandle refers to it, and no object is being created for it.
+     * Removed names are simply added again if they are requested later.
+     *
+     * This may be called while other threads use the Builder. It waits for any
+     * gets which are in progress to finish, so it does nothing when called
+     * from a constructor or a lifecycle hook. Scopes remove their names when
+     * they are destroyed, so do nothing. A sealed Builder keeps every name, so
+     * also does nothing.
+     *
+     * \return The number of names which were removed.
+     */
+    int reclaim();
+
+    /*!
+     * \brief Gets the Configuration used by this Builder.
+     *
+     * \return A pointer to the Configuration used by this Builder. May be null
+     * if none was set. For a scope, this is its parent's Configuration.
+     */
+    QSharedPointer<Configuration> configuration();
+
+    /*!
+     * \brief Gets the configuration section used by this Builder.
+     *
+     * \return The configuration section used by this builder. For a scope,
+     * this is its parent's section.
+     */
+    QString section();
+
+    /*!
+     * \brief Sets the Configuration used by this Builder.
+     *
+     * \param configuration The Configuration to be used by this Builder.
+     * \param section The section within the configuration file to use.
+     *
+     * \throw BuilderException The Builder has been sealed.
+     *
+     * \note Scopes always use their parent's Configuration; calling this on a
+     * scope has no effect.
+     */
+    void setConfiguration(QSharedPointer<Configuration> configuration, const QString &section = "safedart");
+
+    /*!
+     * \brief Freezes the bindings of this Builder, so that names can be
+     * looked up without locking.
+     *
+     * Sealing resolves every name which has been requested so far, along with
+     * the given names, works out how each of their types is constructed, and
+     * compiles the results into an immutable table with a perfect hash. From
+     * then on, looking up one of those names takes no lock and allocates
+     * nothing, which makes it cheap to get objects from many threads at once.
+     *
+     * This is intended to be called once start-up is complete. After sealing:
+     * \li Objects may no longer be provided to the Builder, and its
+     * Configuration may no longer be replaced. Either throws a
+     * BuilderException.
+     * \li Changes to the Configuration's values are ignored.
+     * \li reclaim() does nothing.
+     * \li Names which were not sealed are still resolved, the slower way.
+     *
+     * Sealing a Builder more than once has no effect. Scopes follow their
+     * parent; calling this on a scope has no effect.
+     *
+     * \param names Further names to include, such as those of objects which
+     * will be requested once the application is running.
+     */
+    void seal(const QList<QByteArray> &names = QList<QByteArray>());
+
+    /*!
+     * \brief Checks whether this Builder has been sealed.
+     *
+     * \retval true This Builder, or the Builder it is a scope of, has been
+     * sealed (see seal()).
+     * \retval false Bindings may still be changed.
+     */
+    bool isSealed();
+
+signals:
+    /*!
+     * \brief Emitted when an object is created by the Builder.
+     *
+     * This signal is provided so that the application may perform additional
+     * logic for newly-created objects. This signal is emitted after the object
+     * is instantiated, but before the outermost get() on the same thread
+     * returns. Objects created while constructing another object are emitted
+     * after it has been constructed, in the order in which they were created.
+     *
+     * This signal is a compatibility adapter for a LifecycleHook (see
+     * addLifecycleHook()), which is more efficient for new code.
+     *
+     * \param object A pointer to the object that was created.
+     */
+    void createdObject(QSharedPointer<QObject> object);
+
+    /*!
+     * \brief Emitted when an object is about to be destroyed by the Builder.
+     *
+     * This signal is provided so that the application may perform additional
+     * logic for an object immediately before it is destroyed. This signal is
+     * emitted immediately before the object is deleted, so the pointer that is
+     * passed in should not be kept.
+     *
+     * \param object A pointer to the object that will be destroyed.
+     *
+     * This signal is a compatibility adapter for a LifecycleHook (see
+     * addLifecycleHook()), which is more efficient for new code.
+     *
+     * \warning If this signal is connected in a queued non-blocking fashion,
+     * the object pointer may be invalid by the time the slot is executed. Be
+     * aware that <b>this can happen if automatic connection is used</b>.
+     */
+    void destroyingObject(QObject *object);
+
+protected:
+    template<typename T>
+    friend class Factory;
+
+    template<typename T>
+    friend class ServiceHandle;
+
+    /*!
+     * \brief Creates a scope of the given Builder.
+     *
+     * \param scopeParent The Builder which the new Builder is a scope of.
+     * \param parent The parent QObject of this Builder.
+     *
+     * \see createScope()
+     */
+    Builder(Builder *scopeParent, QObject *parent);
+
+    /*!
+     * \brief A previously-created instance of an object.
+     *
+     * \see InstanceTable::Instance
+     */
+    typedef InstanceTable::Instance Instance;
+
+    /*!
+     * \brief How objects created for a name are shared.
+     *
+     * \see InstanceTable::Lifetime
+     */
+    typedef InstanceTable::Lifetime Lifetime;
+
+    /*!
+     * \brief The Instance which a requested name resolves to.
+     *
+     * \see InstanceTable::Resolution
+     */
+    typedef InstanceTable::Resolution Resolution;
+
+    /*!
+     * \brief A description of how to construct an object of a particular type.
+     *
+     * \see InstanceTable::ConstructionPlan
+     */
+    typedef InstanceTable::ConstructionPlan ConstructionPlan;
+
+    /*!
+     * \brief A parameter of a constructor chosen by the Builder.
+     *
+     * \see InstanceTable::Parameter
+     */
+    typedef InstanceTable::Parameter Parameter;
+
+    /*!
+     * \brief A function which receives the result of an asynchronous get.
+     *
+     * The first argument is the object, and the second is the exception which
+     * prevented it from being gotten, if any; exactly one is set.
+     */
+    typedef std::function<void(QSharedPointer<QObject>, const QException *)> AsyncCallback;
+
+    /*!
+     * \brief A task which gets an object on a thread pool, and delivers it to
+     * everyone waiting for it.
+     */
+    class AsyncGetTask;
+
+    /*!
+     * \brief Collects the objects created on the current thread, and delivers
+     * them to lifecycle hooks once the outermost batch is closed.
+     */
+    class DeliveryBatch;
+
+    /*!
+     * \brief State shared between a Builder and the deleters of the objects it
+     * creates, which may run after the Builder has been destroyed.
+     */
+    struct Lifeline;
+
+    /*!
+     * \brief Installs the hook which emits createdObject() and
+     * destroyingObject() when either signal is first connected.
+     *
+     * \param signal The signal which was connected.
+     */
+    void connectNotify(const QMetaMethod &signal) override;
+
+    /*!
+     * \brief Delivers a batch of created objects to the installed lifecycle
+     * hooks.
+     *
+     * \param objects The objects created, in order of creation.
+     */
+    void deliverCreated(const QList<QSharedPointer<QObject>> &objects);
+
+    /*!
+     * \brief Queues a newly-created object for delivery to the installed
+     * lifecycle hooks, if there are any.
+     *
+     * \param object The object that was created.
+     */
+    void notifyCreated(const QSharedPointer<QObject> &object);
+
+    /*!
+     * \brief Notifies the installed lifecycle hooks, if there are any, that an
+     * object is about to be destroyed.
+     *
+     * \param object The object that will be destroyed.
+     */
+    void notifyDestroying(QObject *object);
+
+    /*!
+     * \brief Gets an object by name without blocking, and passes the result to
+     * a callback.
+     *
+     * This is the implementation of getAsync(). If the object already exists,
+     * \c callback is called immediately, on the calling thread. Otherwise, it
+     * is called on a thread from \c pool once the object has been created.
+     *
+     * \param name The name of the type to instantiate.
+     * \param pool The thread pool on which to create the object, or null to use
+     * the global thread pool.
+     * \param callback The function which receives the result.
+     */
+    void getAsync(const char *name, QThreadPool *pool, const AsyncCallback &callback);
+
+    /*!
+     * \brief Casts an object to a specific type.
+     *
+     * \param object The object to cast.
+     *
+     * \return The object, cast to type T.
+     *
+     * \throw BuilderException The object could not be cast to type T.
+     *
+     * \see interfaceCast()
+     */
+    template<typename T>
+    static QSharedPointer<T> cast(const QSharedPointer<QObject> &object);
+
+    /*!
+     * \brief Casts an object to a specific type, as qobject_cast does.
+     *
+     * qobject_cast compares the name of T against the name of the object's
+     * class and every interface it declares, all the way up its hierarchy. The
+     * result only depends on the object's class, so each thread remembers the
+     * adjustment from QObject to T for the last class it cast to T, and objects
+     * of that class are then cast without any comparisons.
+     *
+     * \param object The object to cast. May be null.
+     *
+     * \return The object, cast to type T, or null if it does not implement T.
+     */
+    template<typename T>
+    static T *interfaceCast(QObject *object);
+
+    /*!
+     * \brief Gets an instance of the object which a name has been resolved to.
+     *
+     * This is the part of get(const char *) which follows resolution.
+     *
+     * \param name The requested name.
+     * \param resolution The current Resolution of \c name.
+     *
+     * \return An instance of the object type associated with the name.
+     *
+     * \throw BuilderException The object could not be found or created.
+     */
+    QSharedPointer<QObject> getResolved(const char *name, Resolution &resolution);
+
+    /*!
+     * \brief Gets the objects for a list of implementation names, without
+     * mapping the names through the Configuration.
+     *
+     * \param names The names of the types to instantiate.
+     *
+     * \return An object of each named type, in the order the names are given.
+     *
+     * \throw BuilderException Any of the objects could not be found or created.
+     *
+     * \see getMulti(const char *)
+     */
+    QList<QSharedPointer<QObject>> getListed(const QList<QByteArray> &names);
+
+    /*!
+     * \brief Gets an object for a name with a pooled lifetime.
+     *
+     * \param name The requested name.
+     * \param resolution The current Resolution of \c name.
+     *
+     * \return An object which is not shared with any other caller.
+     *
+     * \throw BuilderException The object could not be found or created.
+     */
+    QSharedPointer<QObject> getPooled(const char *name, Resolution &resolution);
+
+    /*!
+     * \brief Gets the plan for constructing the object of the given Instance,
+     * working it out the first time.
+     *
+     * \param name The requested name, for error messages.
+     * \param instance The Instance whose object to construct.
+     *
+     * \return The ConstructionPlan, or null if the type has no usable
+     * constructor.
+     *
+     * \throw BuilderException No QObject could be found with the Instance's
+     * name.
+     */
+    const ConstructionPlan *constructionPlan(const char *name, Instance &instance);
+
+    /*!
+     * \brief Finds the QMetaObject for the type of the given Instance.
+     *
+     * Instances whose type could not be found are remembered as missing, and
+     * are not looked up again until FactoryRegistry::revision() changes.
+     *
+     * \param instance The Instance whose type to find.
+     *
+     * \return The QMetaObject, or null if the type could not be found.
+     */
+    const QMetaObject *findMetaObject(Instance &instance);
+
+    /*!
+     * \brief Records that the object currently being constructed by this
+     * thread, if any, depends on the given name.
+     *
+     * \param name The requested name.
+     */
+    void noteDependency(const char *name);
+
+    /*!
+     * \brief Drops the reference which prewarm() kept to the object of an
+     * Instance, now that the object has been requested.
+     *
+     * Callers check \c _prewarmedCount first, so that this costs nothing once
+     * every prewarmed object has been requested.
+     *
+     * \param instance The Instance whose object was requested.
+     */
+    void releasePrewarmed(const Instance &instance);
+
+    /*!
+     * \brief Constructs an object according to a ConstructionPlan.
+     *
+     * Objects injected as <tt>I *</tt> are kept alive by a child of the new
+     * object named InjectedObjectsName.
+     *
+     * \param plan The plan to follow.
+     *
+     * \return The constructed object, or null if construction failed.
+     */
+    QObject *construct(const ConstructionPlan &plan);
+
+    /*!
+     * \brief Constructs a new object on behalf of a Factory.
+     *
+     * The object is not stored by the Builder. Otherwise it is constructed as
+     * get() constructs objects: dependencies and circular dependencies are
+     * detected, the construction is traced and counted in the name's metrics,
+     * and lifecycle hooks are told about the object.
+     *
+     * \param name The requested name.
+     * \param resolution The Resolution of \c name.
+     * \param plan The plan to follow.
+     *
+     * \return The constructed object.
+     *
+     * \throw BuilderException The object depends on itself, or could not be
+     * created.
+     */
+    QSharedPointer<QObject> createTransient(const char *name, Resolution &resolution, const ConstructionPlan &plan);
+
+    /*!
+     * \brief Works out how to construct objects of the type described by a
+     * QMetaObject.
+     *
+     * Of the invokable constructors whose parameters are all either
+     * <tt>Builder *</tt> or injectable interfaces (see
+     * SAFEDART_DECLARE_INJECTABLE()), the one with the most parameters is used.
+     * T(Builder *) is therefore used in preference to T().
+     *
+     * \param metaObject The QMetaObject of the type to construct.
+     *
+     * \return A new ConstructionPlan, or null if the type has no usable
+     * constructor.
+     */
+    ConstructionPlan *planConstruction(const QMetaObject *metaObject);
+
+    /*!
+     * \brief Resolves the given name to an Instance under the current
+     * configuration, creating the Instance if it doesn't exist.
+     *
+     * \param name The requested name.
+     *
+     * \return The Resolution of the given name. It remains valid while the
+     * caller holds an InstanceTable::Guard on the root table, but is only
+     * current while its stamp matches resolutionStamp().
+     */
+    Resolution &resolve(const char *name);
+
+    /*!
+     * \brief Resolves an interned name.
+     *
+     * Functions identically to resolve(const char *), but uses the hash held
+     * by the Atom.
+     *
+     * \param name The requested name.
+     *
+     * \return The Resolution of the given name.
+     */
+    Resolution &resolve(const Atom &name);
+
+    /*!
+     * \brief Resolves the name of a root Instance, unless its Resolution is
+     * still current.
+     *
+     * \param requested The Instance of the requested name.
+     *
+     * \return The Resolution of the Instance's name.
+     */
+    Resolution &resolveInstance(Instance &requested);
+
+    /*!
+     * \brief Resolves several names at once.
+     *
+     * Functions very similarly to resolve(const char *), but reads the
+     * resolution stamp once, and resolves any names whose Resolutions are not
+     * current together.
+     *
+     * \param names The requested names.
+     *
+     * \return The Resolutions of the given names, in the same order.
+     */
+    QVector<Resolution *> resolve(const QList<QByteArray> &names);
+
+    /*!
+     * \brief Resolves names against the Configuration and publishes the
+     * results.
+     *
+     * The Configuration is consulted for each name, and the results are
+     * published while holding \c _resolutionsMutex once for all names.
+     *
+     * \param requested The Instances of the requested names.
+     * \param stamp The resolution stamp, read before calling.
+     *
+     * \return The published Resolutions, in the same order.
+     */
+    QVector<Resolution *> publishResolutions(const QVector<Instance *> &requested, quint64 stamp);
+
+    /*!
+     * \brief Resolves the given name on behalf of a ServiceHandle, and pins
+     * its Instance so that the Resolution remains valid for as long as the
+     * handle holds the Pin.
+     *
+     * \param name The requested name.
+     * \param pin Receives the Pin of the requested name's Instance.
+     *
+     * \return The Resolution of the given name.
+     */
+    Resolution *pinResolution(const char *name, QExplicitlySharedDataPointer<InstanceTable::Pin> &pin);
+
+    /*!
+     * \brief Gets the table of the root Builder, which holds the Instances that
+     * names resolve to.
+     *
+     * \return The InstanceTable of this Builder, or of its root Builder if it
+     * is a scope.
+     */
+    InstanceTable &rootInstances();
+
+    /*!
+     * \brief Gets a value identifying the current configuration.
+     *
+     * The stamp changes whenever the Configuration or section is replaced, or
+     * the Configuration's revision changes, until the Builder is sealed; from
+     * then on, it never changes. A Resolution is only valid while its stamp
+     * matches.
+     *
+     * \return The current resolution stamp.
+     */
+    quint64 resolutionStamp();
+
+    /*!
+     * \brief The Builder which this Builder is a scope of, or null if it is not
+     * a scope.
+     */
+    Builder *_parent;
+
+    /*!
+     * \brief A pointer to the Configuration used by this Builder.
+     */
+    QSharedPointer<Configuration> _configuration;
+
+    /*!
+     * \brief The Arena from which a scope allocates its Instances, and which
+     * keeps the objects it creates alive until the scope is destroyed. Null if
+     * this Builder is not a scope.
+     */
+    QScopedPointer<Arena> _arena;
+
+    /*!
+     * \brief A mapping of object name to the existing instance (if any).
+     *
+     * The table is synchronized internally; looking up an existing name never
+     * takes a lock across the whole table.
+     */
+    InstanceTable _instances;
+
+    /*!
+     * \brief A counter which is incremented whenever the Configuration or
+     * section is replaced.
+     */
+    QAtomicInt _generation;
+
+    /*!
+     * \brief A mutex used to ensure that only one thread publishes a
+     * Resolution at a time.
+     */
+    QMutex _resolutionsMutex;
+
+    /*!
+     * \brief Resolutions which have been replaced, but may still be in use by
+     * other threads. They are deleted when the Instance of their requested
+     * name is reclaimed, or when the Builder is destroyed.
+     */
+    QList<Resolution *> _retiredResolutions;
+
+    /*!
+     * \brief The table of sealed resolutions, or null if the Builder has not
+     * been sealed.
+     */
+    QAtomicPointer<SealedTable> _sealed;
+
+    /*!
+     * \brief Set, while holding \c _resolutionsMutex, once seal() has begun.
+     *
+     * reclaim() checks this under the same lock before unlinking anything, so
+     * that no Instance which a SealedTable may refer to is ever deleted.
+     */
+    bool _sealing;
+
+    /*!
+     * \brief A mapping of object name to the names its constructor requested.
+     */
+    QHash<QByteArray, QSet<QByteArray>> _dependencies;
+
+    /*!
+     * \brief A mutex used to ensure that access to \c _dependencies is
+     * exclusive.
+     */
+    QMutex _dependenciesMutex;
+
+    /*!
+     * \brief The callbacks waiting for each object which is being created
+     * asynchronously, keyed by the name of the object's Instance.
+     */
+    QHash<QByteArray, QList<AsyncCallback>> _pendingGets;
+
+    /*!
+     * \brief A mutex used to ensure that access to \c _pendingGets is
+     * exclusive.
+     */
+    QMutex _pendingGetsMutex;
+
+    /*!
+     * \brief The last collection built by getMulti() for a name.
+     */
+    struct MultiBinding
+    {
+        /*!
+         * \brief The resolution stamp under which the collection was built.
+         */
+        quint64 stamp;
+
+        /*!
+         * \brief The value of \c _provisions when the collection was built.
+         */
+        int provisions;
+
+        /*!
+         * \brief The collection, which is cached only while it is in use.
+         */
+        QWeakPointer<const QList<QSharedPointer<QObject>>> collection;
+
+        /*!
+         * \brief The objects in the collection, from which it is built again
+         * if they all still exist.
+         */
+        QList<QWeakPointer<QObject>> objects;
+    };
+
+    /*!
+     * \brief The collections built by getMulti(), keyed by requested name.
+     */
+    QHash<QByteArray, MultiBinding> _multiBindings;
+
+    /*!
+     * \brief A lock used to ensure that access to \c _multiBindings is
+     * thread-safe.
+     */
+    QReadWriteLock _multiBindingsLock;
+
+    /*!
+     * \brief A counter which is incremented whenever an object is provided to
+     * the root Builder or any of its scopes.
+     */
+    QAtomicInt _provisions;
+
+    /*!
+     * \brief Objects created by prewarm() which have not been requested yet,
+     * kept alive by the Instance they were created for.
+     */
+    QHash<const Instance *, QSharedPointer<QObject>> _prewarmed;
+
+    /*!
+     * \brief The number of objects in \c _prewarmed, which can be read without
+     * locking.
+     */
+    QAtomicInt _prewarmedCount;
+
+    /*!
+     * \brief A mutex used to ensure that access to \c _prewarmed is exclusive.
+     */
+    QMutex _prewarmedMutex;
+
+    /*!
+     * \brief The installed lifecycle hooks, or null if there are none.
+     */
+    QAtomicPointer<QList<LifecycleHook *>> _hooks;
+
+    /*!
+     * \brief A mutex used to ensure that only one thread changes \c _hooks at a
+     * time.
+     */
+    QMutex _hooksMutex;
+
+    /*!
+     * \brief Shared with the deleters of the objects this Builder creates, so
+     * that objects which outlive it no longer report to it.
+     */
+    QSharedPointer<Lifeline> _lifeline;
+
+    /*!
+     * \brief Hook lists which have been replaced, but may still be in use by
+     * other threads.
+     */
+    QList<QList<LifecycleHook *> *> _retiredHooks;
+
+    /*!
+     * \brief The hook which emits createdObject() and destroyingObject(), once
+     * installed.
+     */
+    QScopedPointer<LifecycleHook> _signalHook;
+
+    /*!
+     * \brief Nonzero once \c _signalHook has been installed.
+     */
+    QAtomicInt _signalHookInstalled;
+
+    /*!
+     * \brief A string containing the name of the configuration section to use.
+     */
+    QString _section;
+};
+
+template<typename T>
+QSharedPointer<T> Builder::get(const char *name)
+{
+   return cast<T>(get(name));
+}
+
+template<typename T>
+QSharedPointer<T> Builder::get(const Atom &name)
+{
+   return cast<T>(get(name));
+}
+
+template<typename T>
+QSharedPointer<T> Builder::get()
+{
+   const char *name = qobject_interface_iid<T *>();
+   return get<T>(name);
+}
+
+template<typename T>
+ServiceHandle<T> Builder::handle(const char *name)
+{
+   return ServiceHandle<T>(this, name);
+}
+
+template<typename T>
+ServiceHandle<T> Builder::handle()
+{
+   const char *name = qobject_interface_iid<T *>();
+   return handle<T>(name);
+}
+
+template<typename T>
+QFuture<QSharedPointer<T>> Builder::getAsync(const char *name, QThreadPool *pool)
+{
+   QFutureInterface<QSharedPointer<T>> interface;
+   interface.reportStarted();
+
+   getAsync(name, pool, [interface](QSharedPointer<QObject> object, const QException *error) mutable
+   {
+       T *result = interfaceCast<T>(object.data());
+       if (error)
+           interface.reportException(*error);
+       else if (!result)
+           interface.reportException(BuilderException("Type does not implement the requested service."));
+       else
+           interface.reportResult(QtSharedPointer::copyAndSetPointer(result, object));
+
+       interface.reportFinished();
+   });
+
+   return interface.future();
+}
+
+template<typename T>
+QFuture<QSharedPointer<T>> Builder::getAsync(QThreadPool *pool)
+{
+   const char *name = qobject_interface_iid<T *>();
+   return getAsync<T>(name, pool);
+}
+
+template<typename T>
+GetResult<T> Builder::tryGet(const char *name)
+{
+   GetResult<QObject> result = tryGet(name);
+   if (!result)
+       return GetResult<T>(result);
+
+   T *cast = interfaceCast<T>(result.object().data());
+   if (!cast)
+       return GetResult<T>(WrongTypeError, name, QByteArray());
+   return GetResult<T>(QtSharedPointer::copyAndSetPointer(cast, result.object()));
+}
+
+template<typename T>
+GetResult<T> Builder::tryGet()
+{
+   const char *name = qobject_interface_iid<T *>();
+   return tryGet<T>(name);
+}
+
+template<typename T>
+Factory<T> Builder::factory(const char *name)
+{
+   return Factory<T>(this, name);
+}
+
+template<typename T>
+Factory<T> Builder::factory()
+{
+   const char *name = qobject_interface_iid<T *>();
+   return factory<T>(name);
+}
+
+template<typename T>
+Lazy<T> Builder::lazy(const char *name)
+{
+   return Lazy<T>(this, name);
+}
+
+template<typename T>
+Lazy<T> Builder::lazy()
+{
+   const char *name = qobject_interface_iid<T *>();
+   return lazy<T>(name);
+}
+
+template<typename... T>
+std::tuple<QSharedPointer<T>...> Builder::getAll()
+{
+   QList<QByteArray> names { qobject_interface_iid<T *>()... };
+   QList<QSharedPointer<QObject>> objects = getAll(names);
+
+   // Elements of a braced initializer list are evaluated in order
+   int index = 0;
+   return std::tuple<QSharedPointer<T>...> { cast<T>(objects.at(index++))... };
+}
+
+template<typename T>
+QList<QSharedPointer<T>> Builder::getMulti(const char *name)
+{
+   Collection objects = getMulti(name);
+
+   QList<QSharedPointer<T>> result;
+   result.reserve(objects->size());
+   for (const QSharedPointer<QObject> &object : *objects)
+       result.append(cast<T>(object));
+   return result;
+}
+
+template<typename T>
+QList<QSharedPointer<T>> Builder::getMulti()
+{
+   const char *name = qobject_interface_iid<T *>();
+   return getMulti<T>(name);
+}
+
+template<typename T>
+QSharedPointer<T> Builder::cast(const QSharedPointer<QObject> &object)
+{
+   T *result = interfaceCast<T>(object.data());
+
+   if (!result)
+   {
+        QString message = QString("Type does not implement the requested service.");
+        throw BuilderException(message);
+   }
+
+   // Share ownership with the untyped pointer, as QSharedPointer::objectCast
+   // does
+   return QtSharedPointer::copyAndSetPointer(result, object);
+}
+
+template<typename T>
+T *Builder::interfaceCast(QObject *object)
+{
+   // Only ever touched by the current thread, so no synchronization is needed
+   static thread_local const QMetaObject *lastMetaObject = nullptr;
+   static thread_local qptrdiff lastOffset = 0;
+
+   if (!object)
+       return nullptr;
+
+   const QMetaObject *metaObject = object->metaObject();
+   if (metaObject == lastMetaObject)
+       return reinterpret_cast<T *>(reinterpret_cast<char *>(object) + lastOffset);
+
+   // Failures throw or are reported, so only successful casts are remembered
+   T *result = qobject_cast<T *>(object);
+   if (result)
+   {
+       lastMetaObject = metaObject;
+       lastOffset = reinterpret_cast<char *>(result) - reinterpret_cast<char *>(object);
+   }
+   return result;
+}
+
+#include <factory.h>
+#include <getresult.h>
+#include <lazy.h>
+#include <servicehandle.h>
@@ -28,8 +28,27 @@
 
 #include "configuration.h"
 
+#include <QAtomicInt>
+
 // ********************************************************************** */
 Configuration::~Configuration()
 // ********************************************************************** */
 {
 } // Configuration::~Configuration()
+
+// ********************************************************************** */
+QVariant Configuration::get(const Atom &key, const QVariant &defaultValue)
+// ********************************************************************** */
+{
+    return get(key.toString(), defaultValue);
+} // QVariant Configuration::get(const Atom &key, const QVariant &defaultValue)
+
+// ********************************************************************** */
+int Configuration::revision()
+// ********************************************************************** */
+{
+    // Without a way to tell when the contents change, never report the same
+    // revision twice
+    static QAtomicInt next;
+    return next.fetchAndAddOrdered(1);
+} // int Configuration::revision()
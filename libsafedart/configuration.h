@@ -31,6 +31,8 @@
 #include <QString>
 #include <QVariant>
 
+#include <atom.h>
+
 /*!
  * \brief A generic interface for a source of configuration data.
  *
@@ -63,6 +65,42 @@ public:
      */
     virtual QVariant get(const QString &key, const QVariant &defaultValue = QVariant()) = 0;
 
+    /*!
+     * \brief Gets the value of a configuration entry by its interned key.
+     *
+     * The default implementation calls get(const QString &, const QVariant &)
+     * with the QString held by the Atom, so the key is not converted from
+     * UTF-8 on every call. Implementations which can look keys up by Atom
+     * directly may override this as well.
+     *
+     * \param key The key of the configuration entry to get.
+     * \param defaultValue The value to return if the given key does not exist.
+     *
+     * \return The value stored in the Configuration for the given key, or
+     * \c defaultValue if there is no data for the given key.
+     */
+    virtual QVariant get(const Atom &key, const QVariant &defaultValue = QVariant());
+
+    /*!
+     * \brief Gets a number which changes whenever the contents of this
+     * Configuration change.
+     *
+     * This allows users of the Configuration (such as Builder) to cache values
+     * they have read, and to reuse them for as long as the revision stays the
+     * same.
+     *
+     * \return The current revision of this Configuration.
+     *
+     * The default implementation returns a different number on every call,
+     * so values read from the Configuration are never reused. Implementations
+     * which can track their changes should override it.
+     *
+     * \note Only changes made through this Configuration are required to
+     * change its revision. Changes made directly to an underlying store (a
+     * file, a database, etc.) may go unnoticed.
+     */
+    virtual int revision();
+
     /*!
      * \brief Removes a configuration entry by its key.
      *
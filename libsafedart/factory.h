@@ -0,0 +1,156 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: factory.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QByteArray>
+#include <QExplicitlySharedDataPointer>
+#include <QSharedPointer>
+
+#include <builder.h>
+
+/*!
+ * \brief A handle through which new objects of a specific type are created
+ * repeatedly, gotten from a Builder.
+ *
+ * Builder::get() shares a single object per name. A Factory instead creates a
+ * new object on every call to create(), of the type which its name is
+ * configured to use. The name is resolved and the type's constructor chosen
+ * once; afterwards, create() only checks that the configuration has not
+ * changed before constructing the object. Objects created by a Factory are
+ * not stored by the Builder, and are never shared with any other caller.
+ *
+ * A Factory is obtained through Builder::factory<T>(). This is intended for
+ * objects which are created at a high rate, such as one per message. While a
+ * Factory exists, its name is never removed by Builder::reclaim().
+ *
+ * \note Factory is reentrant, but not thread-safe: a single Factory must not
+ * be used by multiple threads at once. Copies are cheap, so each thread should
+ * use its own copy.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+template<typename T>
+class Factory
+{
+public:
+    /*!
+     * \brief Creates a null Factory, which is not associated with any Builder.
+     */
+    Factory() :
+        _builder(nullptr),
+        _resolution(nullptr),
+        _plan(nullptr)
+    {
+    }
+
+    /*!
+     * \brief Creates a Factory for objects with the given name.
+     *
+     * \param builder The Builder through which to create objects.
+     * \param name The name of the type to instantiate.
+     *
+     * \see Builder::factory<T>(const char *)
+     */
+    Factory(Builder *builder, const char *name) :
+        _builder(builder),
+        _name(name),
+        _resolution(nullptr),
+        _plan(nullptr)
+    {
+    }
+
+    /*!
+     * \brief Creates a new object.
+     *
+     * \return A new instance of the object type associated with this
+     * Factory's name, cast to T.
+     *
+     * \throw BuilderException The object could not be found or created.
+     * \throw BuilderException The object could not be cast to type T.
+     */
+    QSharedPointer<T> create();
+
+    /*!
+     * \brief Checks whether this Factory is associated with a Builder.
+     *
+     * \retval true This Factory is null, and may not be used to create objects.
+     * \retval false This Factory is associated with a Builder.
+     */
+    bool isNull() const { return !_builder; }
+
+private:
+    /*!
+     * \brief The Builder through which objects are created.
+     */
+    Builder *_builder;
+
+    /*!
+     * \brief The name of the type to instantiate.
+     */
+    QByteArray _name;
+
+    /*!
+     * \brief The last known resolution of \c _name, if any.
+     */
+    InstanceTable::Resolution *_resolution;
+
+    /*!
+     * \brief Keeps the Instance of \c _name, and with it \c _resolution, from
+     * being reclaimed.
+     */
+    QExplicitlySharedDataPointer<InstanceTable::Pin> _pin;
+
+    /*!
+     * \brief The plan for constructing objects under \c _resolution.
+     */
+    const InstanceTable::ConstructionPlan *_plan;
+};
+
+template<typename T>
+QSharedPointer<T> Factory<T>::create()
+{
+    // Resolve the name and plan the construction again only if the
+    // configuration has changed
+    if (!_resolution || _resolution->stamp.loadAcquire() != _builder->resolutionStamp())
+    {
+        _plan = nullptr;
+        InstanceTable::Resolution *resolution = _builder->pinResolution(_name.constData(), _pin);
+        _plan = _builder->constructionPlan(_name.constData(), *resolution->instance);
+        _resolution = resolution;
+    }
+    if (!_plan)
+    {
+        QString message = QString("Failed to create %1 for use as %2.")
+                .arg(QString(_resolution->instance->_name))
+                .arg(QString(_name));
+        throw BuilderException(message);
+    }
+
+    QSharedPointer<QObject> object = _builder->createTransient(_name.constData(), *_resolution, *_plan);
+    return Builder::cast<T>(object);
+}
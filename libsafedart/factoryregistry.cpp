@@ -0,0 +1,127 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: factoryregistry.cpp
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+
+#include "factoryregistry.h"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QReadWriteLock>
+
+namespace
+{
+    /*!
+     * \brief The registered factories, keyed by class name, and the
+     * registered injectable interfaces, keyed by interface name.
+     *
+     * Types register themselves during static initialization, in no
+     * particular order, so the registry is created on first use.
+     */
+    struct Registry
+    {
+        QReadWriteLock lock;
+        QHash<QByteArray, FactoryRegistry::Entry *> entries;
+        QHash<QByteArray, FactoryRegistry::Injectable *> injectables;
+
+        ~Registry()
+        {
+            qDeleteAll(entries);
+            qDeleteAll(injectables);
+        }
+    };
+
+    Registry &registry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    /*!
+     * \brief The revision of the set of known types.
+     */
+    QAtomicInt typesRevision;
+}
+
+const FactoryRegistry::Entry *FactoryRegistry::find(const QByteArray &className)
+{
+    Registry &registry = ::registry();
+
+    QReadLocker lock(&registry.lock);
+    Q_UNUSED(lock);
+
+    return registry.entries.value(className);
+} // const FactoryRegistry::Entry *FactoryRegistry::find(const QByteArray &className)
+
+const FactoryRegistry::Injectable *FactoryRegistry::findInjectable(const QByteArray &name)
+{
+    Registry &registry = ::registry();
+
+    QReadLocker lock(&registry.lock);
+    Q_UNUSED(lock);
+
+    return registry.injectables.value(name);
+} // const FactoryRegistry::Injectable *FactoryRegistry::findInjectable(const QByteArray &name)
+
+int FactoryRegistry::revision()
+{
+    return typesRevision.loadAcquire();
+} // int FactoryRegistry::revision()
+
+void FactoryRegistry::typesAdded()
+{
+    typesRevision.ref();
+} // void FactoryRegistry::typesAdded()
+
+void FactoryRegistry::add(const Entry &entry)
+{
+    Registry &registry = ::registry();
+
+    QWriteLocker lock(&registry.lock);
+    Q_UNUSED(lock);
+
+    // A type may be registered by more than one library; entries are handed
+    // out by pointer, so the first registration is kept
+    QByteArray className = entry.metaObject->className();
+    if (!registry.entries.contains(className))
+        registry.entries.insert(className, new Entry(entry));
+
+    typesAdded();
+} // void FactoryRegistry::add(const Entry &entry)
+
+void FactoryRegistry::addInjectable(const char *name, const Injectable &injectable)
+{
+    Registry &registry = ::registry();
+
+    QWriteLocker lock(&registry.lock);
+    Q_UNUSED(lock);
+
+    // Every source file which includes the interface's header registers it
+    // again
+    QByteArray normalized = QMetaObject::normalizedType(name);
+    if (!registry.injectables.contains(normalized))
+        registry.injectables.insert(normalized, new Injectable(injectable));
+} // void FactoryRegistry::addInjectable(const char *name, const Injectable &injectable)
@@ -0,0 +1,324 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: factoryregistry.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QByteArray>
+#include <QMetaObject>
+#include <QMetaType>
+#include <QObject>
+#include <QSharedPointer>
+
+#include <new>
+#include <type_traits>
+
+class Builder;
+
+/*!
+ * \brief A registry of functions which construct types directly, used by
+ * Builder in preference to QMetaObject's constructor lookup.
+ *
+ * Types are registered automatically by Reflectable. For each type, a factory
+ * is registered for each of the T(Builder *) and T() constructors which the
+ * type has; a factory is an ordinary function which calls the constructor, so
+ * creating an object through it involves no argument marshalling or signature
+ * matching.
+ *
+ * Which constructor is used is still decided by the type's QMetaObject, in the
+ * same way as for types which are not registered, so only constructors marked
+ * \c Q_INVOKABLE are ever used. Types which are not registered are constructed
+ * through their QMetaObject.
+ *
+ * FactoryRegistry also records which interfaces may be injected into
+ * constructors, as either <tt>QSharedPointer&lt;I&gt;</tt> or <tt>I *</tt>
+ * arguments. Interfaces are registered with SAFEDART_DECLARE_INJECTABLE().
+ *
+ * \note FactoryRegistry is thread-safe.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+class FactoryRegistry
+{
+public:
+    /*!
+     * \brief A function which constructs an object.
+     *
+     * The argument is the Builder constructing the object. Factories for the
+     * T() constructor ignore it.
+     */
+    typedef QObject *(*Factory)(Builder *);
+
+    /*!
+     * \brief The factories registered for a type.
+     */
+    struct Entry
+    {
+        /*!
+         * \brief The QMetaObject of the type.
+         */
+        const QMetaObject *metaObject;
+
+        /*!
+         * \brief Calls the T(Builder *) constructor, or null if the type has
+         * none.
+         */
+        Factory withBuilder;
+
+        /*!
+         * \brief Calls the T() constructor, or null if the type has none.
+         */
+        Factory withNone;
+    };
+
+    /*!
+     * \brief Storage for a constructor argument injected by Builder, large
+     * enough to hold a <tt>QSharedPointer&lt;I&gt;</tt> or an <tt>I *</tt>.
+     */
+    typedef std::aligned_storage<sizeof(QSharedPointer<QObject>), alignof(QSharedPointer<QObject>)>::type Argument;
+
+    /*!
+     * \brief The functions which convert objects to an injectable interface.
+     *
+     * Each conversion constructs its result in an Argument, even if the object
+     * does not implement the interface; the result is then null.
+     */
+    struct Injectable
+    {
+        /*!
+         * \brief The interface ID, by which Builder gets the object to inject.
+         */
+        const char *iid;
+
+        /*!
+         * \brief Constructs a <tt>QSharedPointer&lt;I&gt;</tt> sharing
+         * ownership of the object.
+         *
+         * \return Whether the object implements the interface.
+         */
+        bool (*toSharedPointer)(Argument *argument, const QSharedPointer<QObject> &object);
+
+        /*!
+         * \brief Constructs an <tt>I *</tt> pointing to the object.
+         *
+         * \return Whether the object implements the interface.
+         */
+        bool (*toPointer)(Argument *argument, const QSharedPointer<QObject> &object);
+
+        /*!
+         * \brief Destroys a <tt>QSharedPointer&lt;I&gt;</tt> constructed by
+         * \c toSharedPointer.
+         */
+        void (*destroySharedPointer)(Argument *argument);
+    };
+
+    /*!
+     * \brief Registers factories for type T, and registers <tt>T *</tt> as a
+     * meta type.
+     *
+     * \return The meta type ID of <tt>T *</tt>.
+     */
+    template<typename T>
+    static int add();
+
+    /*!
+     * \brief Finds the factories registered for a type.
+     *
+     * \param className The name of the type, as given by its QMetaObject.
+     *
+     * \return The factories registered for the type, or null if it has not
+     * been registered. Entries are never removed once registered.
+     */
+    static const Entry *find(const QByteArray &className);
+
+    /*!
+     * \brief Gets the revision of the set of known types.
+     *
+     * \return A number which changes whenever types may have been added.
+     */
+    static int revision();
+
+    /*!
+     * \brief Notes that types may have been added, so that names which were
+     * previously found not to exist are looked up again.
+     *
+     * This is called when types are registered with FactoryRegistry, and by
+     * LibraryModuleLoader after each module is loaded. Code which registers
+     * types by other means, such as <tt>qMetaTypeId&lt;T *&gt;()</tt>, after
+     * they may already have been requested should call it as well.
+     */
+    static void typesAdded();
+
+    /*!
+     * \brief Registers interface I as injectable.
+     *
+     * \param name The name of the interface, as spelled in constructor
+     * signatures.
+     *
+     * \return Always true.
+     */
+    template<typename I>
+    static bool addInjectable(const char *name);
+
+    /*!
+     * \brief Finds an injectable interface.
+     *
+     * \param name The name of the interface, as spelled in normalized
+     * constructor signatures.
+     *
+     * \return The conversions registered for the interface, or null if it has
+     * not been registered. Interfaces are never removed once registered.
+     */
+    static const Injectable *findInjectable(const QByteArray &name);
+
+private:
+    /*!
+     * \brief Registers the factories for a type.
+     *
+     * \param entry The factories to register. If the type is already
+     * registered, the existing registration is kept.
+     */
+    static void add(const Entry &entry);
+
+    /*!
+     * \brief Registers the conversions for an interface.
+     *
+     * \param name The name of the interface.
+     * \param injectable The conversions to register. If the interface is
+     * already registered, the existing registration is kept.
+     */
+    static void addInjectable(const char *name, const Injectable &injectable);
+
+    /*!
+     * \brief Provides the conversions to interface I.
+     */
+    template<typename I>
+    struct Conversions
+    {
+        static bool toSharedPointer(Argument *argument, const QSharedPointer<QObject> &object)
+        {
+            // Share ownership with the untyped pointer, as
+            // QSharedPointer::objectCast does
+            I *cast = qobject_cast<I *>(object.data());
+            if (cast)
+                new (argument) QSharedPointer<I>(QtSharedPointer::copyAndSetPointer(cast, object));
+            else
+                new (argument) QSharedPointer<I>();
+            return cast != nullptr;
+        }
+
+        static bool toPointer(Argument *argument, const QSharedPointer<QObject> &object)
+        {
+            I *cast = qobject_cast<I *>(object.data());
+            new (argument) I *(cast);
+            return cast != nullptr;
+        }
+
+        static void destroySharedPointer(Argument *argument)
+        {
+            reinterpret_cast<QSharedPointer<I> *>(argument)->~QSharedPointer<I>();
+        }
+    };
+
+    /*!
+     * \brief Provides the factory for the T(Builder *) constructor, if T has
+     * one.
+     */
+    template<typename T, bool = std::is_constructible<T, Builder *>::value>
+    struct WithBuilder
+    {
+        static Factory factory() { return nullptr; }
+    };
+
+    template<typename T>
+    struct WithBuilder<T, true>
+    {
+        static QObject *create(Builder *builder) { return new T(builder); }
+        static Factory factory() { return &create; }
+    };
+
+    /*!
+     * \brief Provides the factory for the T() constructor, if T has one.
+     */
+    template<typename T, bool = std::is_default_constructible<T>::value>
+    struct WithNone
+    {
+        static Factory factory() { return nullptr; }
+    };
+
+    template<typename T>
+    struct WithNone<T, true>
+    {
+        static QObject *create(Builder *) { return new T; }
+        static Factory factory() { return &create; }
+    };
+};
+
+template<typename T>
+int FactoryRegistry::add()
+{
+    // T(Builder *) may also be satisfied by a T(QObject *parent) constructor.
+    // Builder only uses the factory if T has an invokable T(Builder *)
+    // constructor, which is then always the better match.
+    Entry entry = { &T::staticMetaObject, WithBuilder<T>::factory(), WithNone<T>::factory() };
+    add(entry);
+
+    return qMetaTypeId<T *>();
+}
+
+template<typename I>
+bool FactoryRegistry::addInjectable(const char *name)
+{
+    Injectable injectable =
+    {
+        qobject_interface_iid<I *>(),
+        &Conversions<I>::toSharedPointer,
+        &Conversions<I>::toPointer,
+        &Conversions<I>::destroySharedPointer
+    };
+    addInjectable(name, injectable);
+
+    return true;
+}
+
+#define SAFEDART_INJECTABLE_NAME2(counter) safedartInjectable##counter
+#define SAFEDART_INJECTABLE_NAME(counter) SAFEDART_INJECTABLE_NAME2(counter)
+
+/*!
+ * \brief Allows Builder to inject interface I into constructors, as either a
+ * <tt>QSharedPointer&lt;I&gt;</tt> or an <tt>I *</tt> argument.
+ *
+ * Use this in the interface's header, after Q_DECLARE_INTERFACE(I, iid). The
+ * interface must be named as it is spelled in the constructors it is injected
+ * into.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+#define SAFEDART_DECLARE_INJECTABLE(I) \
+    namespace \
+    { \
+        Q_DECL_UNUSED const bool SAFEDART_INJECTABLE_NAME(__COUNTER__) = FactoryRegistry::addInjectable<I>(#I); \
+    }
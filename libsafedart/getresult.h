@@ -0,0 +1,181 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: getresult.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+
+#include <builder.h>
+
+/*!
+ * \brief The result of Builder::tryGet(): either an object, or the reason it
+ * could not be gotten.
+ *
+ * Unlike Builder::get(), Builder::tryGet() reports failure through its result
+ * rather than by throwing. The description of a failure is only formatted if
+ * errorString() is called, so probing for optional objects which do not exist
+ * is cheap.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+template<typename T>
+class GetResult
+{
+public:
+    /*!
+     * \brief Creates a successful result.
+     *
+     * \param object The object which was gotten.
+     */
+    GetResult(const QSharedPointer<T> &object) :
+        _object(object),
+        _error(Builder::NoError)
+    {
+    }
+
+    /*!
+     * \brief Creates a failed result.
+     *
+     * \param error The reason the object could not be gotten.
+     * \param name The requested name.
+     * \param type The name of the type which the requested name resolved to.
+     * \param message A description of the failure, if one is already known.
+     */
+    GetResult(Builder::GetError error, const QByteArray &name, const QByteArray &type,
+              const QByteArray &message = QByteArray()) :
+        _error(error),
+        _name(name),
+        _type(type),
+        _message(message)
+    {
+    }
+
+    /*!
+     * \brief Creates a copy of a failed result for another type.
+     *
+     * \param failure The failed result to copy.
+     */
+    template<typename U>
+    explicit GetResult(const GetResult<U> &failure) :
+        _error(failure._error),
+        _name(failure._name),
+        _type(failure._type),
+        _message(failure._message)
+    {
+    }
+
+    /*!
+     * \brief Checks whether the object was gotten.
+     *
+     * \retval true The object was gotten, and is available from object().
+     * \retval false The object could not be gotten; see error().
+     */
+    bool isValid() const { return _error == Builder::NoError; }
+
+    /*!
+     * \brief Checks whether the object was gotten.
+     *
+     * \see isValid()
+     */
+    explicit operator bool() const { return isValid(); }
+
+    /*!
+     * \brief Gets the object.
+     *
+     * \return The object which was gotten, or null if it could not be.
+     */
+    QSharedPointer<T> object() const { return _object; }
+
+    /*!
+     * \brief Gets the reason the object could not be gotten.
+     *
+     * \return The reason, or Builder::NoError if the object was gotten.
+     */
+    Builder::GetError error() const { return _error; }
+
+    /*!
+     * \brief Describes why the object could not be gotten.
+     *
+     * \return The same description which Builder::get() would have thrown, or
+     * an empty string if the object was gotten.
+     */
+    QString errorString() const;
+
+private:
+    template<typename U>
+    friend class GetResult;
+
+    /*!
+     * \brief The object which was gotten, if any.
+     */
+    QSharedPointer<T> _object;
+
+    /*!
+     * \brief The reason the object could not be gotten.
+     */
+    Builder::GetError _error;
+
+    /*!
+     * \brief The requested name.
+     */
+    QByteArray _name;
+
+    /*!
+     * \brief The name of the type which \c _name resolved to.
+     */
+    QByteArray _type;
+
+    /*!
+     * \brief A description of the failure, if it was known when it happened.
+     */
+    QByteArray _message;
+};
+
+template<typename T>
+QString GetResult<T>::errorString() const
+{
+    if (!_message.isEmpty())
+        return QString::fromUtf8(_message);
+
+    switch (_error)
+    {
+    case Builder::NoError:
+        return QString();
+    case Builder::NotFoundError:
+        return QString("Could not find %1 for use as %2.")
+                .arg(QString(_type))
+                .arg(QString(_name));
+    case Builder::WrongTypeError:
+        return QString("Type does not implement the requested service.");
+    default:
+        return QString("Failed to create %1 for use as %2.")
+                .arg(QString(_type))
+                .arg(QString(_name));
+    }
+}
@@ -0,0 +1,99 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: instancepool.cpp
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+
+#include "instancepool.h"
+
+InstancePool::InstancePool(const QMetaObject *metaObject, int capacity) :
+    _capacity(capacity),
+    _highWaterMark(0),
+    _acquisitions(0),
+    _hits(0)
+{
+    int reset = metaObject->indexOfMethod("reset()");
+    if (reset >= 0)
+        _reset = metaObject->method(reset);
+} // InstancePool::InstancePool(const QMetaObject *metaObject, int capacity)
+
+InstancePool::~InstancePool()
+{
+    qDeleteAll(_objects);
+} // InstancePool::~InstancePool()
+
+QObject *InstancePool::acquire()
+{
+    QMutexLocker lock(&_mutex);
+    Q_UNUSED(lock);
+
+    _acquisitions++;
+    if (_objects.isEmpty())
+        return nullptr;
+
+    _hits++;
+    return _objects.takeLast();
+} // QObject *InstancePool::acquire()
+
+bool InstancePool::release(QObject *object)
+{
+    // Don't bother resetting an object which won't fit. This is checked again
+    // below, as the pool may fill up in the meantime.
+    {
+        QMutexLocker lock(&_mutex);
+        Q_UNUSED(lock);
+
+        if (_objects.size() >= _capacity)
+            return false;
+    }
+
+    // Reset the object without holding the lock, as reset() may take a while
+    if (_reset.isValid())
+        _reset.invoke(object, Qt::DirectConnection);
+
+    QMutexLocker lock(&_mutex);
+    Q_UNUSED(lock);
+
+    if (_objects.size() >= _capacity)
+        return false;
+
+    _objects.append(object);
+    _highWaterMark = qMax(_highWaterMark, _objects.size());
+    return true;
+} // bool InstancePool::release(QObject *object)
+
+InstancePool::Statistics InstancePool::statistics() const
+{
+    QMutexLocker lock(&_mutex);
+    Q_UNUSED(lock);
+
+    Statistics statistics;
+    statistics.size = _objects.size();
+    statistics.capacity = _capacity;
+    statistics.highWaterMark = _highWaterMark;
+    statistics.acquisitions = _acquisitions;
+    statistics.hits = _hits;
+    return statistics;
+} // InstancePool::Statistics InstancePool::statistics() const
@@ -0,0 +1,173 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: instancepool.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QList>
+#include <QMetaMethod>
+#include <QMutex>
+#include <QObject>
+
+/*!
+ * \brief A bounded pool of idle objects of a single type, used by Builder for
+ * names with a pooled lifetime.
+ *
+ * When the last reference to a pooled object is released, the object is reset
+ * and kept in the pool instead of being deleted, so that the next request can
+ * reuse it without constructing a new one. If the pool is already full, the
+ * object is deleted as usual.
+ *
+ * An object is reset by invoking its <tt>reset()</tt> method, if it has one.
+ * The method must be marked Q_INVOKABLE (or be a slot), and must return the
+ * object to the state in which a newly-constructed object would be.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+class InstancePool
+{
+public:
+    /*!
+     * \brief A snapshot of the activity of an InstancePool.
+     */
+    struct Statistics
+    {
+        /*!
+         * \brief The number of idle objects currently in the pool.
+         */
+        int size;
+
+        /*!
+         * \brief The maximum number of idle objects the pool will hold.
+         */
+        int capacity;
+
+        /*!
+         * \brief The largest number of idle objects the pool has held at
+         * once.
+         */
+        int highWaterMark;
+
+        /*!
+         * \brief The number of objects requested from the pool.
+         */
+        quint64 acquisitions;
+
+        /*!
+         * \brief The number of requests which were satisfied by an idle
+         * object, rather than by constructing a new one.
+         */
+        quint64 hits;
+
+        /*!
+         * \brief Gets the fraction of requests which were satisfied by an idle
+         * object.
+         *
+         * \return The hit rate, from 0 to 1. 0 if no objects have been
+         * requested.
+         */
+        double hitRate() const
+        {
+            return acquisitions ? double(hits) / double(acquisitions) : 0.0;
+        }
+    };
+
+    /*!
+     * \brief Creates an empty InstancePool.
+     *
+     * \param metaObject The QMetaObject of the type of object to pool.
+     * \param capacity The maximum number of idle objects to hold.
+     */
+    InstancePool(const QMetaObject *metaObject, int capacity);
+
+    /*!
+     * \brief Deletes the InstancePool, along with any idle objects in it.
+     */
+    ~InstancePool();
+
+    /*!
+     * \brief Takes an idle object out of the pool, if there is one.
+     *
+     * \return An idle object, which belongs to the caller, or null if the pool
+     * is empty.
+     */
+    QObject *acquire();
+
+    /*!
+     * \brief Resets an object and returns it to the pool.
+     *
+     * \param object The object to return.
+     *
+     * \retval true The object was returned to the pool.
+     * \retval false The pool is full; the object still belongs to the caller.
+     */
+    bool release(QObject *object);
+
+    /*!
+     * \brief Gets a snapshot of the pool's activity.
+     *
+     * \return The pool's current statistics.
+     */
+    Statistics statistics() const;
+
+private:
+    Q_DISABLE_COPY(InstancePool)
+
+    /*!
+     * \brief A mutex which guards all other members.
+     */
+    mutable QMutex _mutex;
+
+    /*!
+     * \brief The idle objects in the pool.
+     */
+    QList<QObject *> _objects;
+
+    /*!
+     * \brief The reset() method of the pooled type, if it has one.
+     */
+    QMetaMethod _reset;
+
+    /*!
+     * \brief The maximum number of idle objects to hold.
+     */
+    int _capacity;
+
+    /*!
+     * \brief The largest number of idle objects held at once.
+     */
+    int _highWaterMark;
+
+    /*!
+     * \brief The number of objects requested from the pool.
+     */
+    quint64 _acquisitions;
+
+    /*!
+     * \brief The number of requests satisfied by an idle object.
+     */
+    quint64 _hits;
+};
@@ -0,0 +1,466 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: instancetable.cpp
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+
+#include "instancetable.h"
+
+#include <QHash>
+#include <QThread>
+
+#include <cstring>
+#include <new>
+
+namespace
+{
+    /*!
+     * \brief The smallest number of slots allocated for a shard.
+     */
+    const int MinimumCapacity = 16;
+
+    /*!
+     * \brief The number of slots moved from the previous array of a shard which
+     * is being resized, on each insertion.
+     */
+    const int MigrationStep = 32;
+
+    /*!
+     * \brief Marks a slot whose Instance has been removed. Lookups must probe
+     * past it, so it cannot simply be emptied.
+     */
+    InstanceTable::Instance *const Removed = reinterpret_cast<InstanceTable::Instance *>(quintptr(1));
+
+    /*!
+     * \brief Gets the slot at which to start probing for a hash.
+     *
+     * The low bits of the hash also select the shard, so every bit is mixed in
+     * before masking (as the finalizer of MurmurHash3 does).
+     */
+    inline int startSlot(uint hash, int capacity)
+    {
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6bU;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35U;
+        hash ^= hash >> 16;
+        return int(hash & uint(capacity - 1));
+    }
+
+    /*!
+     * \brief The number of Guards held by the current thread, on any table.
+     */
+    thread_local int guardDepth = 0;
+
+    /*!
+     * \brief The source of reader slot indices for new threads.
+     */
+    QAtomicInt nextReaderSlot;
+}
+
+InstanceTable::InstanceTable(Arena *arena) :
+    _shards(static_cast<Shard *>(qMallocAligned(ShardCount * sizeof(Shard), 64))),
+    _arena(arena),
+    _readerSlots(static_cast<ReaderSlot *>(qMallocAligned(ReaderSlotCount * sizeof(ReaderSlot), 64))),
+    _reclaimed(0),
+    _reclaims(0)
+{
+    for (int i = 0; i < ShardCount; i++)
+        new (&_shards[i]) Shard;
+    for (int i = 0; i < ReaderSlotCount; i++)
+        new (&_readerSlots[i]) ReaderSlot;
+} // InstanceTable::InstanceTable(Arena *arena)
+
+InstanceTable::~InstanceTable()
+{
+    // Instances allocated from an Arena are destroyed along with it
+    if (!_arena)
+        qDeleteAll(instances());
+
+    for (int i = 0; i < ShardCount; i++)
+        _shards[i].~Shard();
+    for (int i = 0; i < ReaderSlotCount; i++)
+        _readerSlots[i].~ReaderSlot();
+
+    qFreeAligned(_shards);
+    qFreeAligned(_readerSlots);
+} // InstanceTable::~InstanceTable()
+
+InstanceTable::Instance *InstanceTable::find(const QByteArray &name) const
+{
+    uint hash = qHash(name);
+    Shard &shard = this->shard(hash);
+
+    QReadLocker lock(&shard.lock);
+    Q_UNUSED(lock);
+
+    return shard.find(name, hash);
+} // InstanceTable::Instance *InstanceTable::find(const QByteArray &name) const
+
+InstanceTable::Instance *InstanceTable::find(const Atom &name) const
+{
+    Shard &shard = this->shard(name.hash());
+
+    QReadLocker lock(&shard.lock);
+    Q_UNUSED(lock);
+
+    return shard.find(name.name(), name.hash());
+} // InstanceTable::Instance *InstanceTable::find(const Atom &name) const
+
+InstanceTable::Instance &InstanceTable::operator[](const QByteArray &name)
+{
+    return get(name, qHash(name), false);
+} // InstanceTable::Instance &InstanceTable::operator[](const QByteArray &name)
+
+InstanceTable::Instance &InstanceTable::operator[](const Atom &name)
+{
+    return get(name.name(), name.hash(), true);
+} // InstanceTable::Instance &InstanceTable::operator[](const Atom &name)
+
+InstanceTable::Instance &InstanceTable::get(const QByteArray &name, uint hash, bool interned)
+{
+    // Most names already exist, so look for one under a read lock first
+    Shard &shard = this->shard(hash);
+    {
+        QReadLocker lock(&shard.lock);
+        Q_UNUSED(lock);
+
+        Instance *instance = shard.find(name, hash);
+        if (instance)
+            return *instance;
+    }
+
+    QWriteLocker lock(&shard.lock);
+    Q_UNUSED(lock);
+
+    // Another thread may have added the name since the read lock was released
+    Instance *instance = shard.find(name, hash);
+    if (instance)
+        return *instance;
+
+    // Otherwise, the name may refer to data owned by the caller; the Instance
+    // must own a copy
+    instance = _arena ? _arena->create<Instance>() : new Instance;
+    instance->_name = interned ? name : QByteArray(name.constData(), name.size());
+    shard.insert(instance, hash);
+
+    return *instance;
+} // InstanceTable::Instance &InstanceTable::get(const QByteArray &name, uint hash, bool interned)
+
+QList<InstanceTable::Instance *> InstanceTable::instances() const
+{
+    QList<Instance *> instances;
+    for (int i = 0; i < ShardCount; i++)
+    {
+        QReadLocker lock(&_shards[i].lock);
+        Q_UNUSED(lock);
+
+        _shards[i].collect(instances);
+    }
+
+    return instances;
+} // QList<InstanceTable::Instance *> InstanceTable::instances() const
+
+InstanceTable::Statistics InstanceTable::statistics() const
+{
+    Statistics statistics;
+    statistics.size = size();
+    statistics.reclaimed = _reclaimed.loadAcquire();
+    statistics.reclaims = _reclaims.loadAcquire();
+    return statistics;
+} // InstanceTable::Statistics InstanceTable::statistics() const
+
+int InstanceTable::size() const
+{
+    int size = 0;
+    for (int i = 0; i < ShardCount; i++)
+    {
+        QReadLocker lock(&_shards[i].lock);
+        Q_UNUSED(lock);
+
+        size += _shards[i].size;
+    }
+
+    return size;
+} // int InstanceTable::size() const
+
+void InstanceTable::synchronize() const
+{
+    QMutexLocker lock(&_synchronizeMutex);
+    Q_UNUSED(lock);
+
+    // New Guards count themselves against the new epoch, so the Guards counted
+    // against the old one can only drain
+    int epoch = _epoch.fetchAndAddOrdered(1) & 1;
+    for (int i = 0; i < ReaderSlotCount; i++)
+    {
+        while (_readerSlots[i].readers[epoch].loadAcquire() != 0)
+            QThread::yieldCurrentThread();
+    }
+} // void InstanceTable::synchronize() const
+
+QList<InstanceTable::Instance *> InstanceTable::unlink(const std::function<bool(Instance &)> &reclaimable)
+{
+    QList<Instance *> unlinked;
+    if (_arena)
+        return unlinked;
+
+    for (int i = 0; i < ShardCount; i++)
+    {
+        QWriteLocker lock(&_shards[i].lock);
+        Q_UNUSED(lock);
+
+        _shards[i].unlink(reclaimable, unlinked);
+    }
+
+    if (!unlinked.isEmpty())
+    {
+        _reclaimed.fetchAndAddOrdered(quint64(unlinked.size()));
+        _reclaims.ref();
+    }
+
+    return unlinked;
+} // QList<InstanceTable::Instance *> InstanceTable::unlink(const std::function<bool(Instance &)> &reclaimable)
+
+InstanceTable::Shard &InstanceTable::shard(uint hash) const
+{
+    return _shards[hash % ShardCount];
+} // InstanceTable::Shard &InstanceTable::shard(uint hash) const
+
+InstanceTable::Shard::Shard() :
+    current(),
+    previous(),
+    migrated(0),
+    size(0)
+{
+} // InstanceTable::Shard::Shard()
+
+InstanceTable::Shard::~Shard()
+{
+    qFreeAligned(current.slots);
+    qFreeAligned(previous.slots);
+} // InstanceTable::Shard::~Shard()
+
+InstanceTable::Instance *InstanceTable::Shard::find(const QByteArray &name, uint hash) const
+{
+    // Instances are added to the current array, so most are found there
+    Instance *instance = current.find(name, hash);
+    if (!instance && previous.capacity)
+        instance = previous.find(name, hash);
+
+    return instance;
+} // InstanceTable::Instance *InstanceTable::Shard::find(const QByteArray &name, uint hash) const
+
+void InstanceTable::Shard::insert(Instance *instance, uint hash)
+{
+    if (previous.capacity)
+        migrate(MigrationStep);
+
+    // Keep at least a quarter of the slots empty, so probes stay short. Once
+    // the array fills up, replace it with one sized for the Instances which
+    // remain, and move them across gradually.
+    if ((current.used + 1) * 4 > current.capacity * 3)
+    {
+        if (previous.capacity)
+            migrate(previous.capacity);
+
+        // The old array must be emptied before the new one fills up. Each
+        // insertion moves MigrationStep slots, and at least a quarter of the
+        // new array's slots are filled by insertions before it is resized.
+        int capacity = MinimumCapacity;
+        while (capacity < (size + 1) * 2 || capacity * MigrationStep < current.capacity * 4)
+            capacity *= 2;
+
+        previous = current;
+        current = SlotArray::allocate(capacity);
+        migrated = 0;
+    }
+
+    current.insert(instance, hash);
+    size++;
+} // void InstanceTable::Shard::insert(Instance *instance, uint hash)
+
+void InstanceTable::Shard::unlink(const std::function<bool(Instance &)> &reclaimable, QList<Instance *> &unlinked)
+{
+    SlotArray *arrays[] = { &current, &previous };
+    for (SlotArray *array : arrays)
+    {
+        for (int i = 0; i < array->capacity; i++)
+        {
+            Slot &slot = array->slots[i];
+            if (!slot.instance || slot.instance == Removed || !reclaimable(*slot.instance))
+                continue;
+
+            unlinked.append(slot.instance);
+            slot.instance = Removed;
+            size--;
+        }
+    }
+} // void InstanceTable::Shard::unlink(const std::function<bool(Instance &)> &reclaimable, QList<Instance *> &unlinked)
+
+void InstanceTable::Shard::collect(QList<Instance *> &instances) const
+{
+    const SlotArray *arrays[] = { &current, &previous };
+    for (const SlotArray *array : arrays)
+    {
+        for (int i = 0; i < array->capacity; i++)
+        {
+            Instance *instance = array->slots[i].instance;
+            if (instance && instance != Removed)
+                instances.append(instance);
+        }
+    }
+} // void InstanceTable::Shard::collect(QList<Instance *> &instances) const
+
+void InstanceTable::Shard::migrate(int count)
+{
+    // A moved slot is marked rather than emptied, so that probes for the slots
+    // after it which have not been moved yet still reach them
+    for (int end = qMin(migrated + count, previous.capacity); migrated < end; migrated++)
+    {
+        Slot &slot = previous.slots[migrated];
+        if (!slot.instance || slot.instance == Removed)
+            continue;
+
+        current.insert(slot.instance, slot.hash);
+        slot.instance = Removed;
+    }
+
+    if (migrated == previous.capacity)
+    {
+        qFreeAligned(previous.slots);
+        previous = SlotArray();
+        migrated = 0;
+    }
+} // void InstanceTable::Shard::migrate(int count)
+
+InstanceTable::SlotArray InstanceTable::SlotArray::allocate(int capacity)
+{
+    // Slots are allocated on a cache line boundary, so that a probe touches as
+    // few cache lines as possible
+    SlotArray array;
+    array.slots = static_cast<Slot *>(qMallocAligned(size_t(capacity) * sizeof(Slot), 64));
+    Q_CHECK_PTR(array.slots);
+    memset(array.slots, 0, size_t(capacity) * sizeof(Slot));
+    array.capacity = capacity;
+    array.used = 0;
+    return array;
+} // InstanceTable::SlotArray InstanceTable::SlotArray::allocate(int capacity)
+
+InstanceTable::Instance *InstanceTable::SlotArray::find(const QByteArray &name, uint hash) const
+{
+    if (!capacity)
+        return nullptr;
+
+    // The array always has an empty slot, which ends the probe. The name is
+    // only compared if the hash matches, and names shared with an Atom are
+    // compared by address.
+    int mask = capacity - 1;
+    for (int i = startSlot(hash, capacity); ; i = (i + 1) & mask)
+    {
+        const Slot &slot = slots[i];
+        if (!slot.instance)
+            return nullptr;
+        if (slot.hash != hash || slot.instance == Removed)
+            continue;
+
+        const QByteArray &slotName = slot.instance->_name;
+        if ((slotName.constData() == name.constData() && slotName.size() == name.size()) || slotName == name)
+            return slot.instance;
+    }
+} // InstanceTable::Instance *InstanceTable::SlotArray::find(const QByteArray &name, uint hash) const
+
+void InstanceTable::SlotArray::insert(Instance *instance, uint hash)
+{
+    int mask = capacity - 1;
+    int i = startSlot(hash, capacity);
+    while (slots[i].instance)
+        i = (i + 1) & mask;
+
+    slots[i].hash = hash;
+    slots[i].instance = instance;
+    used++;
+} // void InstanceTable::SlotArray::insert(Instance *instance, uint hash)
+
+InstanceTable::Instance::Instance() :
+    _pin(new Pin)
+{
+} // InstanceTable::Instance::Instance()
+
+InstanceTable::Instance::~Instance()
+{
+    delete _resolution.load();
+    delete _plan.load();
+    delete _pool.load();
+    delete _metrics.load();
+} // InstanceTable::Instance::~Instance()
+
+BindingMetrics &InstanceTable::Instance::metrics()
+{
+    BindingMetrics *metrics = _metrics.loadAcquire();
+    if (metrics)
+        return *metrics;
+
+    // Threads which get here at once each create metrics; one set is kept
+    BindingMetrics *created = new BindingMetrics;
+    if (!_metrics.testAndSetOrdered(nullptr, created))
+        delete created;
+    return *_metrics.loadAcquire();
+} // BindingMetrics &InstanceTable::Instance::metrics()
+
+InstanceTable::Guard::Guard(const InstanceTable &table)
+{
+    thread_local int slot = nextReaderSlot.fetchAndAddRelaxed(1) % ReaderSlotCount;
+    ReaderSlot &readerSlot = table._readerSlots[slot];
+
+    // Count this Guard against the current epoch. If the epoch advanced in the
+    // meantime, synchronize() may already have checked the count, so try again
+    // with the new epoch.
+    forever
+    {
+        int epoch = table._epoch.loadAcquire() & 1;
+        QAtomicInt &readers = readerSlot.readers[epoch];
+        readers.ref();
+        if ((table._epoch.loadAcquire() & 1) == epoch)
+        {
+            _readers = &readers;
+            break;
+        }
+        readers.deref();
+    }
+
+    guardDepth++;
+} // InstanceTable::Guard::Guard(const InstanceTable &table)
+
+InstanceTable::Guard::~Guard()
+{
+    guardDepth--;
+    _readers->deref();
+} // InstanceTable::Guard::~Guard()
+
+bool InstanceTable::Guard::isHeld()
+{
+    return guardDepth > 0;
+} // bool InstanceTable::Guard::isHeld()
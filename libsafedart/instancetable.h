@@ -0,0 +1,746 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: instancetable.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include <QByteArray>
+#include <QExplicitlySharedDataPointer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QSharedData>
+#include <QSharedPointer>
+#include <QVector>
+#include <QWeakPointer>
+
+#include <functional>
+
+#include <arena.h>
+#include <atom.h>
+#include <factoryregistry.h>
+#include <instancepool.h>
+#include <metrics.h>
+
+/*!
+ * \brief A concurrent mapping of object name to the existing instance (if any)
+ * of that object, used by Builder.
+ *
+ * The table is split into a fixed number of shards, each of which is guarded by
+ * its own read-write lock. A name always maps to the same shard, so looking up
+ * an existing name takes only a shared lock on a single shard, and threads
+ * looking up different names rarely touch the same lock. No lock is ever held
+ * across the whole table.
+ *
+ * Each shard keeps its names in a flat array of slots, which is probed
+ * linearly. A slot holds the hash of its name beside a pointer to the
+ * Instance, so a lookup reads consecutive slots from a few cache lines and
+ * only follows the pointer of a slot whose hash matches. When a shard's array
+ * fills up, a larger one is allocated, and the old array's slots are moved
+ * across a few at a time by later insertions; no insertion ever pauses to move
+ * the whole shard.
+ *
+ * Each Instance is allocated separately and is never moved, so a reference
+ * obtained from the table remains valid without holding any lock. Instances
+ * may be allocated from an Arena, in which case the Arena, rather than the
+ * table, owns them.
+ *
+ * Instances allocated from the heap may be reclaimed once they are no longer
+ * needed: unlink() removes them from the table, and synchronize() waits until
+ * no thread can still be using them, after which they may be deleted. Threads
+ * which use Instances from the table must hold a Guard while doing so, and
+ * must not keep a reference once it is released, unless they hold the
+ * Instance's Pin.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+class InstanceTable
+{
+public:
+    struct Instance;
+
+    /*!
+     * \brief How objects created for a name are shared.
+     */
+    enum Lifetime
+    {
+        /*!
+         * \brief A single object is shared by the Builder and all of its
+         * scopes for as long as it is in use. This is the default.
+         */
+        SharedLifetime,
+
+        /*!
+         * \brief Each scope (see Builder::createScope()) creates and shares its
+         * own object.
+         */
+        ScopedLifetime,
+
+        /*!
+         * \brief Each request gets an object of its own, which is taken from
+         * an InstancePool if possible and returned to it once released.
+         */
+        PooledLifetime
+    };
+
+    /*!
+     * \brief The Instance which a requested name resolves to.
+     *
+     * Builder stores a Resolution in the Instance for each name it is asked
+     * for, so that the Configuration does not need to be consulted again until
+     * it changes. A Resolution is never modified after it has been published,
+     * except to renew its \c stamp; if a name resolves to a different Instance,
+     * a new Resolution is published instead.
+     */
+    struct Resolution
+    {
+        /*!
+         * \brief Identifies the configuration under which the name was
+         * resolved. The Resolution is only valid while this matches the
+         * Builder's current stamp.
+         */
+        QAtomicInteger<quint64> stamp;
+
+        /*!
+         * \brief The Instance that the name resolved to.
+         */
+        Instance *instance;
+
+        /*!
+         * \brief The Instance of the requested name itself.
+         */
+        Instance *requested;
+
+        /*!
+         * \brief How objects created for the name are shared.
+         */
+        Lifetime lifetime;
+    };
+
+    /*!
+     * \brief A parameter of a constructor chosen by Builder.
+     */
+    struct Parameter
+    {
+        /*!
+         * \brief The kinds of argument which Builder can pass.
+         */
+        enum Kind
+        {
+            /*!
+             * \brief The Builder constructing the object.
+             */
+            BuilderParameter,
+
+            /*!
+             * \brief A <tt>QSharedPointer&lt;I&gt;</tt> to an injected object.
+             */
+            SharedPointerParameter,
+
+            /*!
+             * \brief An <tt>I *</tt> to an injected object.
+             */
+            PointerParameter
+        };
+
+        /*!
+         * \brief The kind of argument to pass.
+         */
+        Kind kind;
+
+        /*!
+         * \brief The conversions to the injected interface, or null for a
+         * BuilderParameter.
+         */
+        const FactoryRegistry::Injectable *injectable;
+    };
+
+    /*!
+     * \brief A description of how to construct an object of a particular type.
+     *
+     * Finding the QMetaObject for a type and choosing its constructor both
+     * involve looking up strings. Builder does this once per type, and stores
+     * the result as a ConstructionPlan so that objects which expire and are
+     * created again can be constructed directly. For constructors which take
+     * injected objects, the plan also records which object each argument is
+     * gotten by, so the type's dependencies are known before it is first
+     * constructed.
+     */
+    struct ConstructionPlan
+    {
+        /*!
+         * \brief The QMetaObject of the type to construct.
+         */
+        const QMetaObject *metaObject;
+
+        /*!
+         * \brief The index of the constructor to use within \c metaObject.
+         */
+        int constructor;
+
+        /*!
+         * \brief Whether the constructor is T(Builder *).
+         */
+        bool takesBuilder;
+
+        /*!
+         * \brief The constructor's parameters, in order.
+         */
+        QVector<Parameter> parameters;
+
+        /*!
+         * \brief A function which calls the constructor directly, if the type
+         * registered one with FactoryRegistry; otherwise null, and the
+         * constructor is invoked through \c metaObject.
+         */
+        FactoryRegistry::Factory factory;
+    };
+
+    /*!
+     * \brief A token which keeps an Instance from being reclaimed, for as long
+     * as anything other than the Instance holds a reference to it.
+     *
+     * The Pin is reference-counted separately from the Instance, so that it can
+     * safely be released even after the table has been destroyed.
+     */
+    struct Pin : public QSharedData
+    {
+    };
+
+    /*!
+     * \brief A previously-created instance of an object.
+     *
+     * The Instance struct contains the necessary information to maintain a
+     * reference to a shared object while it exists, without preventing it from
+     * being deleted. It also allows creation of the object to be synchronized
+     * to ensure that only one instance of the object exists at a time.
+     *
+     * \note QWeakPointer itself is thread-safe, so exclusive access is not
+     * required to be able to access an existing instance of the object. If
+     * there is no existing instance of the object, however, only one should be
+     * created. In this case, a lock is used, so that only one thread will
+     * attempt to create an object. This ensures that only one instance of the
+     * object will exist at any given time.
+     */
+    struct Instance
+    {
+        /*!
+         * \brief A mutex which synchronizes the creation of the instance stored
+         * in \c _reference.
+         *
+         * No lock is needed be used when reading the value of the pointer, but
+         * a lock should be held when creating the object. To ensure proper
+         * synchronization, \c _reference should be checked again after locking
+         * the mutex and before creating an instance of the object.
+         */
+        QMutex _referenceMutex;
+
+        /*!
+         * \brief A weak pointer to the existing instance of the object, if any.
+         */
+        QWeakPointer<QObject> _reference;
+
+        /*!
+         * \brief The name under which this Instance is stored in the table.
+         */
+        QByteArray _name;
+
+        /*!
+         * \brief The most recent resolution of this Instance's name, if any.
+         *
+         * Resolutions which are replaced are not deleted immediately, as other
+         * threads may still be reading them; see Builder.
+         */
+        QAtomicPointer<Resolution> _resolution;
+
+        /*!
+         * \brief How to construct the object named \c _name, once known.
+         *
+         * The plan is published once, by whichever thread works it out first,
+         * and never changes once set.
+         */
+        QAtomicPointer<const ConstructionPlan> _plan;
+
+        /*!
+         * \brief One more than the FactoryRegistry::revision() at which no
+         * type named \c _name could be found, or zero if it has not been
+         * looked for without success.
+         *
+         * The type is not looked for again until the revision changes.
+         */
+        QAtomicInt _missing;
+
+        /*!
+         * \brief The pool of idle objects named \c _name, if it is used with a
+         * pooled lifetime.
+         *
+         * The pool is created on first use, and never changes once set.
+         */
+        QAtomicPointer<InstancePool> _pool;
+
+        /*!
+         * \brief Metrics describing gets of \c _name, or null until metrics()
+         * is first called.
+         *
+         * Held by pointer so that the layout of Instance does not depend on
+         * whether SAFE-DART was built with metrics, while a build without them
+         * never allocates any.
+         */
+        QAtomicPointer<BindingMetrics> _metrics;
+
+        /*!
+         * \brief The Pin for this Instance. The Instance is not reclaimed while
+         * anything else holds a reference to it.
+         */
+        QExplicitlySharedDataPointer<Pin> _pin;
+
+        /*!
+         * \brief Nonzero once the Instance has been unlinked from the table.
+         *
+         * A thread which finds this set after locking \c _referenceMutex, or
+         * after pinning the Instance, must look the name up again.
+         */
+        QAtomicInt _reclaimed;
+
+        Instance();
+        ~Instance();
+
+        /*!
+         * \brief Gets the metrics describing gets of \c _name, creating them
+         * on first use.
+         *
+         * Only called where metrics are collected (see SAFEDART_METRIC()).
+         */
+        BindingMetrics &metrics();
+    };
+
+    /*!
+     * \brief Statistics describing the size of an InstanceTable and the
+     * Instances reclaimed from it.
+     */
+    struct Statistics
+    {
+        /*!
+         * \brief The number of names currently in the table.
+         */
+        int size;
+
+        /*!
+         * \brief The total number of Instances which have been reclaimed.
+         */
+        quint64 reclaimed;
+
+        /*!
+         * \brief The number of times Instances have been reclaimed.
+         */
+        quint64 reclaims;
+    };
+
+    /*!
+     * \brief Keeps Instances found in an InstanceTable from being deleted, for
+     * as long as it exists.
+     *
+     * Holding a Guard is cheap: it touches only a counter which is shared with
+     * few other threads.
+     */
+    class Guard
+    {
+    public:
+        /*!
+         * \brief Holds off the reclamation of Instances from the given table.
+         *
+         * \param table The table whose Instances will be used.
+         */
+        explicit Guard(const InstanceTable &table);
+
+        /*!
+         * \brief Allows Instances found since the Guard was created to be
+         * reclaimed.
+         */
+        ~Guard();
+
+        /*!
+         * \brief Checks whether the current thread holds a Guard on any table.
+         *
+         * \retval true The current thread holds a Guard, so must not wait in
+         * synchronize().
+         * \retval false The current thread holds no Guard.
+         */
+        static bool isHeld();
+
+    private:
+        Q_DISABLE_COPY(Guard)
+
+        /*!
+         * \brief The reader count which was incremented for this Guard.
+         */
+        QAtomicInt *_readers;
+    };
+
+    /*!
+     * \brief Creates an empty InstanceTable.
+     *
+     * \param arena The Arena from which to allocate Instances, or null to
+     * allocate them from the heap. The Arena must outlive the table.
+     */
+    explicit InstanceTable(Arena *arena = nullptr);
+    ~InstanceTable();
+
+    /*!
+     * \brief Finds the Instance for the given name, if there is one.
+     *
+     * \param name The name of the object whose Instance to find.
+     *
+     * \return A pointer to the Instance for the given name, or null if the name
+     * has never been added to the table.
+     */
+    Instance *find(const QByteArray &name) const;
+
+    /*!
+     * \brief Finds the Instance for the given interned name, if there is one.
+     *
+     * Functions identically to find(const QByteArray &), but uses the hash
+     * held by the Atom rather than hashing the name again.
+     *
+     * \param name The name of the object whose Instance to find.
+     *
+     * \return A pointer to the Instance for the given name, or null if the name
+     * has never been added to the table.
+     */
+    Instance *find(const Atom &name) const;
+
+    /*!
+     * \brief Gets the Instance for the given name, adding an empty one if it
+     * does not already exist.
+     *
+     * \param name The name of the object whose Instance to get.
+     *
+     * \return A reference to the Instance for the given name.
+     */
+    Instance &operator[](const QByteArray &name);
+
+    /*!
+     * \brief Gets the Instance for the given interned name, adding an empty one
+     * if it does not already exist.
+     *
+     * Functions identically to operator[](const QByteArray &), but uses the
+     * hash held by the Atom. An Instance added this way shares its name with
+     * the Atom, so later lookups by the same Atom compare names by address.
+     *
+     * \param name The name of the object whose Instance to get.
+     *
+     * \return A reference to the Instance for the given name.
+     */
+    Instance &operator[](const Atom &name);
+
+    /*!
+     * \brief Gets every Instance in the table.
+     *
+     * \return Pointers to every Instance which has been added to the table, in
+     * no particular order.
+     */
+    QList<Instance *> instances() const;
+
+    /*!
+     * \brief Gets the number of names in the table.
+     *
+     * \return The number of names which have been added to the table.
+     */
+    int size() const;
+
+    /*!
+     * \brief Gets statistics describing the table.
+     *
+     * \return The size of the table and the number of Instances reclaimed.
+     */
+    Statistics statistics() const;
+
+    /*!
+     * \brief Removes every Instance which the given predicate accepts from the
+     * table.
+     *
+     * The predicate is called for each Instance with the Instance's shard
+     * locked for writing, so it must not use the table itself. The slots of
+     * removed Instances are only reused once their shard is next resized. The removed
+     * Instances are not deleted, as other threads may still be using them;
+     * call synchronize() before deleting them. Tables whose Instances are
+     * allocated from an Arena never remove anything.
+     *
+     * \param reclaimable Returns true if the given Instance is to be removed.
+     *
+     * \return The Instances which were removed.
+     */
+    QList<Instance *> unlink(const std::function<bool(Instance &)> &reclaimable);
+
+    /*!
+     * \brief Waits until every Guard which existed when the call was made has
+     * been released.
+     *
+     * Once this returns, no thread can still be using an Instance which had
+     * been unlinked beforehand. Must not be called by a thread which holds a
+     * Guard, as it would wait for itself.
+     */
+    void synchronize() const;
+
+private:
+    Q_DISABLE_COPY(InstanceTable)
+
+    /*!
+     * \brief The number of shards the table is split into.
+     */
+    static const int ShardCount = 32;
+
+    /*!
+     * \brief A slot in a shard, which may hold an Instance.
+     */
+    struct Slot
+    {
+        /*!
+         * \brief The hash of the Instance's name.
+         */
+        uint hash;
+
+        /*!
+         * \brief The Instance held by the slot, null if the slot has never been
+         * used, or a marker if its Instance has been removed.
+         */
+        Instance *instance;
+    };
+
+    /*!
+     * \brief An array of slots, probed linearly.
+     *
+     * The array is aligned to a cache line, so slots never straddle one.
+     */
+    struct SlotArray
+    {
+        /*!
+         * \brief Allocates an array of empty slots.
+         *
+         * \param capacity The number of slots, which must be a power of two.
+         */
+        static SlotArray allocate(int capacity);
+
+        /*!
+         * \brief Finds the Instance with the given name and hash.
+         *
+         * \return The Instance, or null if the array does not contain it.
+         */
+        Instance *find(const QByteArray &name, uint hash) const;
+
+        /*!
+         * \brief Puts an Instance into the first free slot for its hash.
+         */
+        void insert(Instance *instance, uint hash);
+
+        /*!
+         * \brief The slots, or null if none have been allocated.
+         */
+        Slot *slots;
+
+        /*!
+         * \brief The number of slots, which is zero or a power of two.
+         */
+        int capacity;
+
+        /*!
+         * \brief The number of slots which hold or have held an Instance.
+         */
+        int used;
+    };
+
+    /*!
+     * \brief A portion of the table, containing the names whose hash selects it.
+     *
+     * Each shard is aligned and padded to a cache line so that threads using
+     * neighbouring shards do not contend on the same cache line.
+     */
+    struct alignas(64) Shard
+    {
+        Shard();
+        ~Shard();
+
+        /*!
+         * \brief Finds the Instance with the given name and hash.
+         *
+         * \return The Instance, or null if the shard does not contain it.
+         */
+        Instance *find(const QByteArray &name, uint hash) const;
+
+        /*!
+         * \brief Adds an Instance which the shard does not already contain.
+         *
+         * Also moves a few slots from \c previous, if the shard is being
+         * resized.
+         */
+        void insert(Instance *instance, uint hash);
+
+        /*!
+         * \brief Removes every Instance which the given predicate accepts, and
+         * appends them to \c unlinked.
+         */
+        void unlink(const std::function<bool(Instance &)> &reclaimable, QList<Instance *> &unlinked);
+
+        /*!
+         * \brief Appends every Instance in the shard to \c instances.
+         */
+        void collect(QList<Instance *> &instances) const;
+
+        /*!
+         * \brief Moves up to \c count slots from \c previous to \c current,
+         * freeing \c previous once it is empty.
+         */
+        void migrate(int count);
+
+        /*!
+         * \brief A lock which guards the rest of the shard. Lookups take a read
+         * lock; insertions take a write lock.
+         */
+        mutable QReadWriteLock lock;
+
+        /*!
+         * \brief The array to which Instances are added.
+         */
+        SlotArray current;
+
+        /*!
+         * \brief The array which \c current replaced, while its slots are
+         * being moved to \c current; otherwise empty.
+         */
+        SlotArray previous;
+
+        /*!
+         * \brief The number of slots at the start of \c previous which have
+         * been moved.
+         */
+        int migrated;
+
+        /*!
+         * \brief The number of Instances in the shard.
+         */
+        int size;
+
+        /*!
+         * \brief Unused; rounds the size of the shard up to a cache line.
+         */
+        char padding[64 - sizeof(QReadWriteLock) - 2 * sizeof(SlotArray) - 2 * sizeof(int)];
+    };
+
+    static_assert(sizeof(Shard) == 64, "A Shard must fill exactly one cache line");
+
+    /*!
+     * \brief The number of reader counters which Guards are spread across.
+     */
+    static const int ReaderSlotCount = 16;
+
+    /*!
+     * \brief The counts of Guards held by the threads sharing a slot.
+     *
+     * Each slot is aligned and padded to a cache line, for the same reason as
+     * a Shard.
+     */
+    struct alignas(64) ReaderSlot
+    {
+        /*!
+         * \brief The number of Guards held, for each of the two epochs.
+         */
+        QAtomicInt readers[2];
+
+        /*!
+         * \brief Unused; rounds the size of the slot up to a cache line.
+         */
+        char padding[64 - 2 * sizeof(QAtomicInt)];
+    };
+
+    static_assert(sizeof(ReaderSlot) == 64, "A ReaderSlot must fill exactly one cache line");
+
+    /*!
+     * \brief Gets the shard which contains names with the given hash.
+     *
+     * \param hash The hash of the name to find the shard of.
+     *
+     * \return The shard which contains the name.
+     */
+    Shard &shard(uint hash) const;
+
+    /*!
+     * \brief Gets the Instance for the given name, adding an empty one if it
+     * does not already exist.
+     *
+     * \param name The name of the object whose Instance to get.
+     * \param hash The hash of \c name.
+     * \param interned Whether \c name is held by an Atom, in which case a new
+     * Instance shares it rather than copying it.
+     *
+     * \return A reference to the Instance for the given name.
+     */
+    Instance &get(const QByteArray &name, uint hash, bool interned);
+
+    /*!
+     * \brief The shards making up the table, in an array of \c ShardCount.
+     *
+     * The array is allocated separately, since operator new does not
+     * guarantee that an InstanceTable itself is aligned to a cache line.
+     */
+    Shard *_shards;
+
+    /*!
+     * \brief The Arena from which Instances are allocated, if any.
+     */
+    Arena *_arena;
+
+    /*!
+     * \brief The reader counters which Guards are spread across, in an array
+     * of \c ReaderSlotCount allocated as \c _shards is.
+     */
+    ReaderSlot *_readerSlots;
+
+    /*!
+     * \brief The current epoch. New Guards count themselves against its
+     * lowest bit; synchronize() advances it and waits for the Guards counted
+     * against the previous epoch to be released.
+     */
+    mutable QAtomicInt _epoch;
+
+    /*!
+     * \brief A mutex which ensures that only one thread advances the epoch at a
+     * time.
+     */
+    mutable QMutex _synchronizeMutex;
+
+    /*!
+     * \brief The total number of Instances which have been unlinked.
+     */
+    QAtomicInteger<quint64> _reclaimed;
+
+    /*!
+     * \brief The number of calls to unlink() which removed any Instances.
+     */
+    QAtomicInteger<quint64> _reclaims;
+};
@@ -0,0 +1,187 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: lazy.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QMutex>
+#include <QSharedPointer>
+
+#include <builder.h>
+
+/*!
+ * \brief A proxy for an object of a specific type, which is gotten from a
+ * Builder the first time it is used.
+ *
+ * A Lazy records the Builder and name it was created with, but does not call
+ * Builder::get<T>(const char *) until it is first dereferenced. From then on,
+ * it holds the object and returns it directly. This lets an object declare all
+ * of its collaborators up front, while only creating (and loading the modules
+ * of) those which are actually used.
+ *
+ * A Lazy is obtained through Builder::lazy<T>(). Copies share the same object:
+ * whichever copy is dereferenced first gets it for all of them.
+ *
+ * \note Lazy is thread-safe: if several threads dereference it at once, the
+ * object is gotten only once, and every thread sees the same object.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+template<typename T>
+class Lazy
+{
+public:
+    /*!
+     * \brief Creates a null Lazy, which is not associated with any Builder.
+     */
+    Lazy()
+    {
+    }
+
+    /*!
+     * \brief Creates a Lazy for the object with the given name.
+     *
+     * \param builder The Builder from which to get the object.
+     * \param name The name of the type to instantiate.
+     *
+     * \see Builder::lazy<T>(const char *)
+     */
+    Lazy(Builder *builder, const char *name) :
+        _state(new State(builder, name))
+    {
+    }
+
+    /*!
+     * \brief Gets the object, getting it from the Builder if this is the first
+     * use.
+     *
+     * \return An instance of the object type associated with this proxy's
+     * name, cast to T.
+     *
+     * \throw BuilderException The object could not be found or created.
+     * \throw BuilderException The object could not be cast to type T.
+     *
+     * \see Builder::get<T>(const char *)
+     */
+    QSharedPointer<T> get() const;
+
+    /*!
+     * \brief Accesses a member of the object, getting it first if necessary.
+     *
+     * \see get()
+     */
+    T *operator->() const { return get().data(); }
+
+    /*!
+     * \brief Dereferences the object, getting it first if necessary.
+     *
+     * \see get()
+     */
+    T &operator*() const { return *get(); }
+
+    /*!
+     * \brief Checks whether the object has been gotten yet.
+     *
+     * \retval true The object has been gotten, and get() will return it
+     * without consulting the Builder.
+     * \retval false The object has not been gotten yet, or this Lazy is null.
+     */
+    bool isResolved() const { return _state && _state->resolved.loadAcquire(); }
+
+    /*!
+     * \brief Checks whether this Lazy is associated with a Builder.
+     *
+     * \retval true This Lazy is null, and may not be dereferenced.
+     * \retval false This Lazy is associated with a Builder.
+     */
+    bool isNull() const { return !_state; }
+
+private:
+    /*!
+     * \brief The state shared by copies of a Lazy.
+     */
+    struct State
+    {
+        State(Builder *builder, const char *name) :
+            builder(builder),
+            name(name)
+        {
+        }
+
+        /*!
+         * \brief The Builder from which to get the object.
+         */
+        Builder *builder;
+
+        /*!
+         * \brief The name of the type to instantiate.
+         */
+        QByteArray name;
+
+        /*!
+         * \brief A mutex which ensures that the object is only gotten once.
+         */
+        QMutex mutex;
+
+        /*!
+         * \brief Nonzero once \c object has been set. Set with release
+         * semantics, so that a thread which sees it set also sees \c object.
+         */
+        QAtomicInt resolved;
+
+        /*!
+         * \brief The object, once gotten.
+         */
+        QSharedPointer<T> object;
+    };
+
+    /*!
+     * \brief The state shared by copies of this Lazy, or null if it is null.
+     */
+    QSharedPointer<State> _state;
+};
+
+template<typename T>
+QSharedPointer<T> Lazy<T>::get() const
+{
+    // Once resolved, the object never changes and can be read without locking
+    if (_state->resolved.loadAcquire())
+        return _state->object;
+
+    QMutexLocker lock(&_state->mutex);
+    Q_UNUSED(lock);
+
+    // Another thread may have gotten the object while this one waited
+    if (!_state->resolved.loadAcquire())
+    {
+        _state->object = _state->builder->get<T>(_state->name.constData());
+        _state->resolved.storeRelease(1);
+    }
+
+    return _state->object;
+}
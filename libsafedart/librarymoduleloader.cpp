@@ -26,10 +26,14 @@
 **
 ********************************************************************** */
 
+#include "factoryregistry.h"
 #include "librarymoduleloader.h"
+#include "tracer.h"
 
 #include <QDir>
+#include <QFileInfo>
 #include <QLibrary>
+#include <QScopedPointer>
 #include <QSet>
 
 // ********************************************************************** */
@@ -57,6 +61,11 @@ QList<ModuleLoader::Module> LibraryModuleLoader::getLoadedModules() const
 bool LibraryModuleLoader::loadModule(const QString &name)
 // ********************************************************************** */
 {
+    // Only work out the module's file name if it will be traced
+    QScopedPointer<Tracer::Span> span;
+    if (Tracer::isEnabled())
+        span.reset(new Tracer::Span("module", QFileInfo(name).fileName().toUtf8().constData(), name.toUtf8().constData()));
+
     QLibrary library(name);
     if (!library.load())
     {
@@ -77,6 +86,10 @@ bool LibraryModuleLoader::loadModule(const QString &name)
         modules.append(module);
     }
 
+    // The module may have registered types which were previously requested
+    // and found not to exist
+    FactoryRegistry::typesAdded();
+
     emit loadedModule(module.path, module.name, module.version);
     return true;
 
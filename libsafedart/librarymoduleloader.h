@@ -59,6 +59,8 @@ public:
     Q_INVOKABLE explicit LibraryModuleLoader(QObject *parent = 0);
     ~LibraryModuleLoader();
 
+    using ModuleLoader::loadModule;
+
     QList<Module> getLoadedModules() const override;
     bool loadModule(const QString &name) override;
     int  loadModulesFromDir(const QString &path) override;
@@ -39,24 +39,50 @@
     OBJECTS_DIR = $$PWD/obj
 }
 
+# Add "metrics" to CONFIG to have Builder collect per-binding metrics
+metrics {
+    DEFINES += SAFEDART_METRICS
+}
+
 INCLUDEPATH += \
     $$PWD
 
 HEADERS += \
     $$PWD/application.h \
+    $$PWD/arena.h \
+    $$PWD/atom.h \
     $$PWD/builder.h \
     $$PWD/configuration.h \
     $$PWD/doxygen.h \
+    $$PWD/factory.h \
+    $$PWD/factoryregistry.h \
+    $$PWD/getresult.h \
+    $$PWD/instancepool.h \
+    $$PWD/instancetable.h \
+    $$PWD/lazy.h \
     $$PWD/librarymoduleloader.h \
+    $$PWD/lifecyclehook.h \
     $$PWD/memoryconfiguration.h \
+    $$PWD/metrics.h \
     $$PWD/module.h \
     $$PWD/moduleloader.h \
     $$PWD/reflectable.h \
-    $$PWD/settingsconfiguration.h
+    $$PWD/sealedtable.h \
+    $$PWD/servicehandle.h \
+    $$PWD/settingsconfiguration.h \
+    $$PWD/tracer.h
 
 SOURCES += \
+    $$PWD/arena.cpp \
+    $$PWD/atom.cpp \
     $$PWD/builder.cpp \
     $$PWD/configuration.cpp \
+    $$PWD/factoryregistry.cpp \
+    $$PWD/instancepool.cpp \
+    $$PWD/instancetable.cpp \
     $$PWD/librarymoduleloader.cpp \
     $$PWD/memoryconfiguration.cpp \
-    $$PWD/settingsconfiguration.cpp
+    $$PWD/metrics.cpp \
+    $$PWD/sealedtable.cpp \
+    $$PWD/settingsconfiguration.cpp \
+    $$PWD/tracer.cpp
@@ -0,0 +1,79 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: lifecyclehook.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QSharedPointer>
+
+class Builder;
+
+/*!
+ * \brief Receives notifications about the objects a Builder creates and
+ * destroys.
+ *
+ * A LifecycleHook is installed with Builder::addLifecycleHook(). Builder only
+ * does any work for hooks while at least one is installed; otherwise,
+ * creating and destroying objects costs nothing extra.
+ *
+ * Hooks are never called while the Builder holds the lock of an Instance.
+ * Objects created together are delivered together: when constructing an
+ * object causes other objects to be constructed, or several objects are
+ * gotten through Builder::getAll(), all of them are delivered in a single call
+ * to objectsCreated() once the outermost get has finished, in the order in
+ * which they were created.
+ *
+ * Hooks are called on whichever thread created or released the object, and
+ * must therefore be thread-safe. They must not throw exceptions.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+class LifecycleHook
+{
+public:
+    virtual ~LifecycleHook() {}
+
+    /*!
+     * \brief Called after a batch of objects has been created.
+     *
+     * \param builder The Builder which created the objects.
+     * \param objects The objects that were created, in order of creation.
+     */
+    virtual void objectsCreated(Builder *builder, const QList<QSharedPointer<QObject>> &objects) = 0;
+
+    /*!
+     * \brief Called immediately before an object is destroyed.
+     *
+     * This cannot be batched, as the object is deleted as soon as the call
+     * returns. The pointer should not be kept.
+     *
+     * \param builder The Builder which created the object.
+     * \param object The object that will be destroyed.
+     */
+    virtual void objectDestroying(Builder *builder, QObject *object) = 0;
+};
@@ -81,6 +81,7 @@ void MemoryConfiguration::clear()
     Q_UNUSED(_locker);
 
     _hash.clear();
+    _revision.ref();
 } // void MemoryConfiguration::clear()
 
 // ********************************************************************** */
@@ -97,6 +98,13 @@ QVariant MemoryConfiguration::get(const QString &key, const QVariant &defaultVal
     return iter.value();
 } // QVariant MemoryConfiguration::get(const QString &key, const QVariant &defaultValue)
 
+// ********************************************************************** */
+int MemoryConfiguration::revision()
+// ********************************************************************** */
+{
+    return _revision.loadAcquire();
+} // int MemoryConfiguration::revision()
+
 // ********************************************************************** */
 void MemoryConfiguration::remove(const QString &key)
 // ********************************************************************** */
@@ -105,6 +113,7 @@ void MemoryConfiguration::remove(const QString &key)
     Q_UNUSED(_locker);
 
     _hash.remove(key);
+    _revision.ref();
 } // void MemoryConfiguration::remove(const QString &key)
 
 // ********************************************************************** */
@@ -115,5 +124,6 @@ void MemoryConfiguration::set(const QString &key, const QVariant &value)
     Q_UNUSED(_locker);
 
     _hash[key] = value;
+    _revision.ref();
 } // void MemoryConfiguration::set(const QString &key, const QVariant &value)
 
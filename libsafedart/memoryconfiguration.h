@@ -27,6 +27,7 @@
 ********************************************************************** */
 #pragma once
 
+#include <QAtomicInt>
 #include <QHash>
 #include <QObject>
 #include <QReadWriteLock>
@@ -98,8 +99,11 @@ public:
      */
     MemoryConfiguration(MemoryConfiguration &&move, QObject *parent = 0);
 
+    using Configuration::get;
+
     void clear() override;
     QVariant get(const QString &key, const QVariant &defaultValue) override;
+    int revision() override;
     void remove(const QString &key) override;
     void set(const QString &key, const QVariant &value) override;
 
@@ -115,4 +119,10 @@ protected:
      * synchronized.
      */
     mutable QReadWriteLock _hashLock;
+
+    /*!
+     * \brief The revision of this Configuration, which is incremented whenever
+     * its contents are changed.
+     */
+    QAtomicInt _revision;
 };
@@ -0,0 +1,99 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: metrics.cpp
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+
+#include "metrics.h"
+
+#include <QtAlgorithms>
+
+void LatencyHistogram::record(qint64 nanoseconds)
+{
+    // The bucket is the position of the highest set bit
+    quint64 duration = quint64(qMax(nanoseconds, qint64(0)));
+    int bucket = duration ? 63 - int(qCountLeadingZeroBits(duration)) : 0;
+
+    _buckets[qMin(bucket, BucketCount - 1)].fetchAndAddRelaxed(1);
+    _total.fetchAndAddRelaxed(duration);
+} // void LatencyHistogram::record(qint64 nanoseconds)
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.buckets.resize(BucketCount);
+    snapshot.count = 0;
+    for (int i = 0; i < BucketCount; i++)
+    {
+        snapshot.buckets[i] = _buckets[i].loadAcquire();
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.total = _total.loadAcquire();
+
+    return snapshot;
+} // LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+
+double LatencyHistogram::Snapshot::mean() const
+{
+    return count ? double(total) / double(count) : 0.0;
+} // double LatencyHistogram::Snapshot::mean() const
+
+quint64 LatencyHistogram::Snapshot::percentile(double fraction) const
+{
+    if (!count)
+        return 0;
+
+    // Find the bucket which holds the requested rank
+    quint64 rank = quint64(fraction * double(count));
+    quint64 seen = 0;
+    for (int i = 0; i < buckets.size(); i++)
+    {
+        seen += buckets.at(i);
+        if (seen > rank)
+            return quint64(2) << i;
+    }
+
+    return quint64(2) << (buckets.size() - 1);
+} // quint64 LatencyHistogram::Snapshot::percentile(double fraction) const
+
+double BindingMetrics::Snapshot::hitRate() const
+{
+    quint64 total = hits + misses;
+    return total ? double(hits) / double(total) : 0.0;
+} // double BindingMetrics::Snapshot::hitRate() const
+
+BindingMetrics::Snapshot BindingMetrics::snapshot(const QByteArray &name) const
+{
+    Snapshot snapshot;
+    snapshot.name = name;
+    snapshot.gets = gets.loadAcquire();
+    snapshot.hits = hits.loadAcquire();
+    snapshot.misses = misses.loadAcquire();
+    snapshot.live = live.loadAcquire();
+    snapshot.getLatency = getLatency.snapshot();
+    snapshot.constructionTime = constructionTime.snapshot();
+    snapshot.lockWait = lockWait.snapshot();
+    return snapshot;
+} // BindingMetrics::Snapshot BindingMetrics::snapshot(const QByteArray &name) const
@@ -0,0 +1,242 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: metrics.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QVector>
+
+/*!
+ * \brief Expands to its arguments if SAFE-DART was built with metrics enabled,
+ * and to nothing otherwise.
+ *
+ * Metrics are enabled by defining \c SAFEDART_METRICS, which qmake does when
+ * \c metrics is added to \c CONFIG. When they are disabled, Builder does no
+ * work to collect them.
+ */
+#ifdef SAFEDART_METRICS
+#define SAFEDART_METRIC(...) __VA_ARGS__
+#else
+#define SAFEDART_METRIC(...)
+#endif
+
+/*!
+ * \brief A lock-free histogram of durations, with buckets whose bounds are
+ * powers of two nanoseconds.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+class LatencyHistogram
+{
+public:
+    /*!
+     * \brief The number of buckets. Bucket \c i counts durations of less than
+     * 2^(i + 1) nanoseconds which did not fit in any earlier bucket; the last
+     * bucket also counts anything longer.
+     */
+    static const int BucketCount = 40;
+
+    /*!
+     * \brief A copy of the contents of a LatencyHistogram at some moment.
+     */
+    struct Snapshot
+    {
+        /*!
+         * \brief The number of durations counted by each bucket.
+         */
+        QVector<quint64> buckets;
+
+        /*!
+         * \brief The number of durations recorded.
+         */
+        quint64 count;
+
+        /*!
+         * \brief The sum of all durations recorded, in nanoseconds.
+         */
+        quint64 total;
+
+        /*!
+         * \brief Gets the mean of the recorded durations.
+         *
+         * \return The mean duration in nanoseconds, or 0 if none were recorded.
+         */
+        double mean() const;
+
+        /*!
+         * \brief Gets an upper bound on a percentile of the recorded durations.
+         *
+         * \param fraction The percentile, from 0 to 1; for instance, 0.99 for
+         * the 99th percentile.
+         *
+         * \return The upper bound, in nanoseconds, of the bucket which contains
+         * the percentile, or 0 if no durations were recorded.
+         */
+        quint64 percentile(double fraction) const;
+    };
+
+    /*!
+     * \brief Records a duration.
+     *
+     * \param nanoseconds The duration to record.
+     */
+    void record(qint64 nanoseconds);
+
+    /*!
+     * \brief Gets a copy of the histogram's contents.
+     *
+     * \return The histogram's contents. Durations recorded while the copy is
+     * taken may or may not be included.
+     */
+    Snapshot snapshot() const;
+
+private:
+    /*!
+     * \brief The number of durations counted by each bucket.
+     */
+    QAtomicInteger<quint64> _buckets[BucketCount];
+
+    /*!
+     * \brief The sum of all durations recorded, in nanoseconds.
+     */
+    QAtomicInteger<quint64> _total;
+};
+
+/*!
+ * \brief Counters and histograms describing how a single name has been gotten
+ * from a Builder.
+ *
+ * Builder keeps a BindingMetrics in the Instance of each requested name when
+ * SAFE-DART is built with metrics enabled (see SAFEDART_METRIC).
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+struct BindingMetrics
+{
+    /*!
+     * \brief A copy of a BindingMetrics at some moment.
+     */
+    struct Snapshot
+    {
+        /*!
+         * \brief The requested name.
+         */
+        QByteArray name;
+
+        /*!
+         * \brief The number of completed gets.
+         */
+        quint64 gets;
+
+        /*!
+         * \brief The number of gets satisfied by an existing object.
+         */
+        quint64 hits;
+
+        /*!
+         * \brief The number of gets which constructed a new object.
+         */
+        quint64 misses;
+
+        /*!
+         * \brief The number of objects constructed for the name which still
+         * exist.
+         */
+        int live;
+
+        /*!
+         * \brief How long gets took, from start to finish.
+         */
+        LatencyHistogram::Snapshot getLatency;
+
+        /*!
+         * \brief How long constructors took.
+         */
+        LatencyHistogram::Snapshot constructionTime;
+
+        /*!
+         * \brief How long gets waited to lock the Instance before
+         * constructing an object.
+         */
+        LatencyHistogram::Snapshot lockWait;
+
+        /*!
+         * \brief Gets the fraction of gets satisfied by an existing object.
+         *
+         * \return The hit rate, from 0 to 1, or 0 if there were no hits or
+         * misses.
+         */
+        double hitRate() const;
+    };
+
+    /*!
+     * \brief The number of completed gets.
+     */
+    QAtomicInteger<quint64> gets;
+
+    /*!
+     * \brief The number of gets satisfied by an existing object.
+     */
+    QAtomicInteger<quint64> hits;
+
+    /*!
+     * \brief The number of gets which constructed a new object.
+     */
+    QAtomicInteger<quint64> misses;
+
+    /*!
+     * \brief The number of objects constructed for the name which still exist.
+     */
+    QAtomicInt live;
+
+    /*!
+     * \brief How long gets took, from start to finish.
+     */
+    LatencyHistogram getLatency;
+
+    /*!
+     * \brief How long constructors took.
+     */
+    LatencyHistogram constructionTime;
+
+    /*!
+     * \brief How long gets waited to lock the Instance before constructing an
+     * object.
+     */
+    LatencyHistogram lockWait;
+
+    /*!
+     * \brief Gets a copy of the metrics.
+     *
+     * \param name The name which the metrics describe.
+     *
+     * \return The current values of the metrics.
+     */
+    Snapshot snapshot(const QByteArray &name) const;
+};
@@ -31,6 +31,8 @@
 #include <QObject>
 #include <QString>
 
+#include <atom.h>
+
 /*!
  * \brief An interface for loading modules.
  *
@@ -90,6 +92,20 @@ public:
      */
     virtual bool loadModule(const QString &name) = 0;
 
+    /*!
+     * \brief Loads a single module by its interned name or path.
+     *
+     * Functions identically to loadModule(const QString &), which it calls
+     * with the QString held by the Atom.
+     *
+     * \param name The name of the module to load.
+     *
+     * \retval true The module was loaded successfully.
+     * \retval false The module was not able to be loaded; no further
+     * information is available.
+     */
+    virtual bool loadModule(const Atom &name) { return loadModule(name.toString()); }
+
     /*!
      * \brief Loads all of the modules in a specific directory.
      *
@@ -29,6 +29,8 @@
 
 #include <QMetaType>
 
+#include <factoryregistry.h>
+
 /*!
  * \brief Automatically registers a type for reflection on initialization.
  *
@@ -46,6 +48,10 @@
  * In order to use this class, simply extend any class T which should be
  * accessible via reflection from <tt>Reflectable&lt;T&gt;</tt>.
  *
+ * Reflectable also registers T's T(Builder *) and T() constructors with
+ * FactoryRegistry, so that Builder can construct T with a plain function call
+ * rather than through its QMetaObject.
+ *
  * \warning This will always work when the subclass is compiled as part of an
  * executable or shared library. However, it will only work in a static library
  * if the class is referenced directly by other code that is in use. Otherwise,
@@ -77,9 +83,9 @@ private:
      * The value of this isn't important, and isn't used for anything. The
      * initialization process itself is what is important. Getting the meta type
      * ID registers the meta type for <tt>T *</tt>, which allows it to be used
-     * via reflection.
+     * via reflection, and T's factories are registered along with it.
      */
     static const int _id;
 };
 
-template<typename T> const int Reflectable<T>::_id = qMetaTypeId<T *>();
+template<typename T> const int Reflectable<T>::_id = FactoryRegistry::add<T>();
@@ -0,0 +1,200 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: sealedtable.cpp
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+
+#include "sealedtable.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    /*!
+     * \brief The number of displacements tried for a bucket before the table
+     * is built again with more slots.
+     */
+    const quint32 MaxDisplacement = 1 << 16;
+
+    /*!
+     * \brief Mixes the bits of a 64-bit value, as the finalizer of SplitMix64
+     * does.
+     */
+    inline quint64 mix(quint64 value)
+    {
+        value = (value ^ (value >> 30)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+        value = (value ^ (value >> 27)) * Q_UINT64_C(0x94d049bb133111eb);
+        return value ^ (value >> 31);
+    }
+
+    /*!
+     * \brief Gets the smallest power of two which is no less than a value.
+     */
+    int nextPowerOfTwo(int value)
+    {
+        int power = 1;
+        while (power < value)
+            power <<= 1;
+        return power;
+    }
+}
+
+SealedTable::SealedTable(const QVector<InstanceTable::Resolution *> &resolutions, quint64 stamp) :
+    _stamp(stamp),
+    _size(0)
+{
+    QVector<quint64> allHashes(resolutions.size());
+    for (int i = 0; i < resolutions.size(); i++)
+    {
+        const QByteArray &name = resolutions.at(i)->requested->_name;
+        allHashes[i] = Atom::wideHash(name.constData(), name.size());
+    }
+
+    // No displacement can separate names whose full hashes are equal, so
+    // leave them out; they are still found the slower way, through the
+    // InstanceTable
+    QVector<int> order(resolutions.size());
+    for (int i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&allHashes](int first, int second)
+    {
+        return allHashes.at(first) < allHashes.at(second);
+    });
+
+    QVector<InstanceTable::Resolution *> included;
+    QVector<quint64> hashes;
+    for (int i = 0; i < order.size(); i++)
+    {
+        quint64 hash = allHashes.at(order.at(i));
+        bool shared = (i > 0 && allHashes.at(order.at(i - 1)) == hash) ||
+                (i + 1 < order.size() && allHashes.at(order.at(i + 1)) == hash);
+        if (shared)
+            continue;
+
+        included.append(resolutions.at(order.at(i)));
+        hashes.append(hash);
+    }
+    _size = included.size();
+
+    // With twice as many slots as names, every bucket almost always finds a
+    // displacement quickly; if one does not, try again with more slots
+    int slotCount = nextPowerOfTwo(qMax(1, 2 * included.size()));
+    while (!build(included, hashes, slotCount))
+        slotCount *= 2;
+} // SealedTable::SealedTable(const QVector<InstanceTable::Resolution *> &resolutions, quint64 stamp)
+
+InstanceTable::Resolution *SealedTable::find(const char *name, int size) const
+{
+    return find(name, size, Atom::wideHash(name, size));
+} // InstanceTable::Resolution *SealedTable::find(const char *name, int size) const
+
+InstanceTable::Resolution *SealedTable::find(const Atom &name) const
+{
+    return find(name.constData(), name.size(), name.wideHash());
+} // InstanceTable::Resolution *SealedTable::find(const Atom &name) const
+
+InstanceTable::Resolution *SealedTable::find(const char *name, int size, quint64 hash) const
+{
+    quint32 bucket = quint32(hash >> 32) & quint32(_displacements.size() - 1);
+    const Slot &slot = _slots.at(int(this->slot(hash, _displacements.at(int(bucket)))));
+
+    if (!slot.resolution || slot.hash != hash || slot.size != size)
+        return nullptr;
+
+    // Names shared with an Atom need not be compared byte by byte
+    if (slot.name == name || memcmp(slot.name, name, size_t(size)) == 0)
+        return slot.resolution;
+    return nullptr;
+} // InstanceTable::Resolution *SealedTable::find(const char *name, int size, quint64 hash) const
+
+quint32 SealedTable::slot(quint64 hash, quint32 displacement) const
+{
+    return quint32(mix(hash + displacement * Q_UINT64_C(0x9e3779b97f4a7c15))) & quint32(_slots.size() - 1);
+} // quint32 SealedTable::slot(quint64 hash, quint32 displacement) const
+
+bool SealedTable::build(const QVector<InstanceTable::Resolution *> &resolutions, const QVector<quint64> &hashes,
+                        int slotCount)
+{
+    // About two names per bucket
+    int bucketCount = nextPowerOfTwo(qMax(1, resolutions.size() / 2));
+    Slot empty = { 0, nullptr, nullptr, 0 };
+    _displacements.fill(0, bucketCount);
+    _slots.fill(empty, slotCount);
+
+    QVector<QVector<int>> buckets(bucketCount);
+    for (int i = 0; i < hashes.size(); i++)
+        buckets[int(quint32(hashes.at(i) >> 32) & quint32(bucketCount - 1))].append(i);
+
+    // Place the largest buckets first, while the most slots are free
+    QVector<int> order(bucketCount);
+    for (int i = 0; i < bucketCount; i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&buckets](int first, int second)
+    {
+        return buckets.at(first).size() > buckets.at(second).size();
+    });
+
+    QVector<quint32> placed;
+    for (int bucket : order)
+    {
+        const QVector<int> &members = buckets.at(bucket);
+        if (members.isEmpty())
+            break;
+
+        // Find a displacement which puts every name in the bucket into a
+        // different free slot
+        quint32 displacement = 0;
+        for (; displacement < MaxDisplacement; displacement++)
+        {
+            placed.clear();
+            for (int member : members)
+            {
+                quint32 index = slot(hashes.at(member), displacement);
+                if (_slots.at(int(index)).resolution || placed.contains(index))
+                    break;
+                placed.append(index);
+            }
+
+            if (placed.size() == members.size())
+                break;
+        }
+        if (displacement == MaxDisplacement)
+            return false;
+
+        _displacements[bucket] = displacement;
+        for (int i = 0; i < members.size(); i++)
+        {
+            InstanceTable::Resolution *resolution = resolutions.at(members.at(i));
+            Slot &slot = _slots[int(placed.at(i))];
+            slot.hash = hashes.at(members.at(i));
+            slot.resolution = resolution;
+            slot.name = resolution->requested->_name.constData();
+            slot.size = resolution->requested->_name.size();
+        }
+    }
+
+    return true;
+} // bool SealedTable::build(const QVector<InstanceTable::Resolution *> &resolutions, const QVector<quint64> &hashes, int slotCount)
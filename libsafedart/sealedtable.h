@@ -0,0 +1,177 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: sealedtable.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+#include <atom.h>
+#include <instancetable.h>
+
+/*!
+ * \brief An immutable table of name resolutions, looked up through a perfect
+ * hash.
+ *
+ * Builder compiles its resolutions into a SealedTable when it is sealed (see
+ * Builder::seal()). Since the table never changes, looking a name up takes no
+ * lock and allocates nothing: the name is hashed once, and the hash selects a
+ * single slot, which either holds the name or shows that the table does not
+ * contain it.
+ *
+ * The hash is built by hashing and displacing: names are first divided into
+ * buckets, and each bucket is given a displacement which moves all of its
+ * names into free slots. Slots are kept together in one array, and each
+ * records the full hash of its name, so a lookup touches one bucket, one slot,
+ * and only compares names if their hashes match.
+ *
+ * \note SealedTable is thread-safe.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+class SealedTable
+{
+public:
+    /*!
+     * \brief Compiles a table from a list of resolutions.
+     *
+     * Names whose full hashes are equal cannot be told apart by any
+     * displacement, so they are left out of the table; find() returns null
+     * for them, and Builder resolves them the usual way.
+     *
+     * \param resolutions The resolutions to include, keyed by the names of
+     * their requested Instances. Each name must appear only once, and the
+     * Instances must outlive the table.
+     * \param stamp The resolution stamp under which the resolutions are
+     * current.
+     */
+    SealedTable(const QVector<InstanceTable::Resolution *> &resolutions, quint64 stamp);
+
+    /*!
+     * \brief Finds the resolution of a name.
+     *
+     * \param name The name to find. It need not be null-terminated.
+     * \param size The length of \c name.
+     *
+     * \return The resolution of the name, or null if the table does not
+     * contain it.
+     */
+    InstanceTable::Resolution *find(const char *name, int size) const;
+
+    /*!
+     * \brief Finds the resolution of an interned name.
+     *
+     * Uses the hash held by the Atom, so the name is not hashed again. A name
+     * whose requested Instance shares the Atom's data is matched by address.
+     *
+     * \param name The name to find.
+     *
+     * \return The resolution of the name, or null if the table does not
+     * contain it.
+     */
+    InstanceTable::Resolution *find(const Atom &name) const;
+
+    /*!
+     * \brief Gets the resolution stamp under which the table was compiled.
+     */
+    quint64 stamp() const { return _stamp; }
+
+    /*!
+     * \brief Gets the number of names in the table, excluding any which were
+     * left out because their hashes collided.
+     */
+    int size() const { return _size; }
+
+private:
+    /*!
+     * \brief A slot which may hold a name.
+     */
+    struct Slot
+    {
+        /*!
+         * \brief The full hash of the name.
+         */
+        quint64 hash;
+
+        /*!
+         * \brief The resolution of the name, or null if the slot is empty.
+         */
+        InstanceTable::Resolution *resolution;
+
+        /*!
+         * \brief The name, which is owned by the resolution's requested
+         * Instance.
+         */
+        const char *name;
+
+        /*!
+         * \brief The length of \c name.
+         */
+        int size;
+    };
+
+    /*!
+     * \brief Finds the resolution of a name, given its hash from
+     * Atom::wideHash().
+     */
+    InstanceTable::Resolution *find(const char *name, int size, quint64 hash) const;
+
+    /*!
+     * \brief Finds the slot for a hash within a bucket with the given
+     * displacement.
+     */
+    quint32 slot(quint64 hash, quint32 displacement) const;
+
+    /*!
+     * \brief Tries to build the table with the given number of slots.
+     *
+     * \return Whether every bucket could be given a displacement.
+     */
+    bool build(const QVector<InstanceTable::Resolution *> &resolutions, const QVector<quint64> &hashes,
+               int slotCount);
+
+    /*!
+     * \brief The displacement of each bucket. The number of buckets is a power
+     * of two.
+     */
+    QVector<quint32> _displacements;
+
+    /*!
+     * \brief The slots. The number of slots is a power of two.
+     */
+    QVector<Slot> _slots;
+
+    /*!
+     * \brief The resolution stamp under which the table was compiled.
+     */
+    quint64 _stamp;
+
+    /*!
+     * \brief The number of names in the table.
+     */
+    int _size;
+};
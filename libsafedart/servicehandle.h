@@ -0,0 +1,199 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: servicehandle.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QByteArray>
+#include <QExplicitlySharedDataPointer>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+#include <builder.h>
+
+/*!
+ * \brief A pre-resolved handle to an object of a specific type, gotten from a
+ * Builder.
+ *
+ * Getting an object through Builder::get<T>() looks up its name and casts the
+ * object to T on every call. A ServiceHandle does both once, and afterwards
+ * only checks that its results are still current: getting an object which
+ * already exists costs little more than promoting a weak pointer. This makes
+ * ServiceHandle suitable for objects which are used inside hot loops.
+ *
+ * A ServiceHandle is obtained through Builder::handle<T>(). It behaves exactly
+ * as Builder::get<T>(const char *) would; if the configuration changes or the
+ * object is replaced, the handle follows. While a handle exists, its name is
+ * never removed by Builder::reclaim().
+ *
+ * \note ServiceHandle is reentrant, but not thread-safe: a single handle must
+ * not be used by multiple threads at once. Copies are cheap, so each thread
+ * should use its own copy.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+template<typename T>
+class ServiceHandle
+{
+public:
+    /*!
+     * \brief Creates a null ServiceHandle, which is not associated with any
+     * Builder.
+     */
+    ServiceHandle() :
+        _builder(nullptr),
+        _resolution(nullptr),
+        _object(nullptr),
+        _cast(nullptr)
+    {
+    }
+
+    /*!
+     * \brief Creates a ServiceHandle for objects with the given name.
+     *
+     * \param builder The Builder from which to get objects.
+     * \param name The name of the type to instantiate.
+     *
+     * \see Builder::handle<T>(const char *)
+     */
+    ServiceHandle(Builder *builder, const char *name) :
+        _builder(builder),
+        _name(name),
+        _resolution(nullptr),
+        _object(nullptr),
+        _cast(nullptr)
+    {
+    }
+
+    /*!
+     * \brief Gets the object associated with this handle.
+     *
+     * \return An instance of the object type associated with this handle's
+     * name, cast to T.
+     *
+     * \throw BuilderException The object could not be found or created.
+     * \throw BuilderException The object could not be cast to type T.
+     *
+     * \see Builder::get<T>(const char *)
+     */
+    QSharedPointer<T> get();
+
+    /*!
+     * \brief Checks whether this handle is associated with a Builder.
+     *
+     * \retval true This handle is null, and may not be used to get objects.
+     * \retval false This handle is associated with a Builder.
+     */
+    bool isNull() const { return !_builder; }
+
+private:
+    /*!
+     * \brief The Builder from which objects are gotten.
+     */
+    Builder *_builder;
+
+    /*!
+     * \brief The name of the type to instantiate.
+     */
+    QByteArray _name;
+
+    /*!
+     * \brief The last known resolution of \c _name, if any.
+     */
+    InstanceTable::Resolution *_resolution;
+
+    /*!
+     * \brief Keeps the Instance of \c _name, and with it \c _resolution, from
+     * being reclaimed.
+     */
+    QExplicitlySharedDataPointer<InstanceTable::Pin> _pin;
+
+    /*!
+     * \brief The object which \c _cast was computed for, if any.
+     *
+     * Only compared against; never dereferenced.
+     */
+    QObject *_object;
+
+    /*!
+     * \brief A weak reference to \c _object.
+     *
+     * This is used to tell whether \c _object still exists. If it does not,
+     * another object may since have been created at the same address.
+     */
+    QWeakPointer<QObject> _objectReference;
+
+    /*!
+     * \brief The result of casting \c _object to T.
+     */
+    T *_cast;
+};
+
+template<typename T>
+QSharedPointer<T> ServiceHandle<T>::get()
+{
+    // Resolve the name again only if the configuration has changed
+    if (!_resolution || _resolution->stamp.loadAcquire() != _builder->resolutionStamp())
+        _resolution = _builder->pinResolution(_name.constData(), _pin);
+
+    // Use the existing object if there is one; otherwise, have the Builder
+    // create it. Scopes may hold objects of their own, and pooled objects are
+    // never shared, so in those cases the Builder is always asked.
+    QSharedPointer<QObject> object;
+    if (!_builder->_parent && _resolution->lifetime == InstanceTable::SharedLifetime)
+        object = _resolution->instance->_reference;
+    if (!object)
+    {
+        object = _builder->get(_name.constData());
+    }
+    else
+    {
+        SAFEDART_METRIC(_resolution->requested->metrics().gets.ref());
+        SAFEDART_METRIC(_resolution->requested->metrics().hits.ref());
+        if (_builder->_prewarmedCount.loadAcquire())
+            _builder->releasePrewarmed(*_resolution->instance);
+    }
+
+    // Cast the object again only if it is not the one that was cast last time,
+    // in the same way as Builder::get<T>() does
+    if (object.data() != _object || _objectReference.isNull())
+    {
+        T *cast = Builder::interfaceCast<T>(object.data());
+        if (!cast)
+        {
+            QString message = QString("Type does not implement the requested service.");
+            throw BuilderException(message);
+        }
+
+        _object = object.data();
+        _objectReference = object;
+        _cast = cast;
+    }
+
+    // Share ownership with the untyped pointer, as QSharedPointer::objectCast
+    // does
+    return QtSharedPointer::copyAndSetPointer(_cast, object);
+}
@@ -44,6 +44,7 @@ void SettingsConfiguration::clear()
     Q_UNUSED(_locker);
 
     _settings->clear();
+    _revision.ref();
 } // void SettingsConfiguration::clear()
 
 // ********************************************************************** */
@@ -56,6 +57,13 @@ QVariant SettingsConfiguration::get(const QString &key, const QVariant &defaultV
     return _settings->value(key, defaultValue);
 } // QVariant SettingsConfiguration::get(const QString &key, const QVariant &defaultValue)
 
+// ********************************************************************** */
+int SettingsConfiguration::revision()
+// ********************************************************************** */
+{
+    return _revision.loadAcquire();
+} // int SettingsConfiguration::revision()
+
 // ********************************************************************** */
 void SettingsConfiguration::remove(const QString &key)
 // ********************************************************************** */
@@ -64,6 +72,7 @@ void SettingsConfiguration::remove(const QString &key)
     Q_UNUSED(_locker);
 
     _settings->remove(key);
+    _revision.ref();
 } // void SettingsConfiguration::remove(const QString &key)
 
 // ********************************************************************** */
@@ -73,5 +82,6 @@ void SettingsConfiguration::set(const QString &key, const QVariant &value)
     QMutexLocker _locker(&_settingsMutex);
     Q_UNUSED(_locker);
 
-    return _settings->setValue(key, value);
+    _settings->setValue(key, value);
+    _revision.ref();
 } // void SettingsConfiguration::set(const QString &key, const QVariant &value)
@@ -27,6 +27,7 @@
 ********************************************************************** */
 #pragma once
 
+#include <QAtomicInt>
 #include <QMutex>
 #include <QObject>
 #include <QSettings>
@@ -68,8 +69,11 @@ public:
      */
     explicit SettingsConfiguration(QSettings *settings, QObject *parent = 0);
 
+    using Configuration::get;
+
     void clear() override;
     QVariant get(const QString &key, const QVariant &defaultValue) override;
+    int revision() override;
     void remove(const QString &key) override;
     void set(const QString &key, const QVariant &value) override;
 
@@ -84,4 +88,10 @@ protected:
      * \brief A mutex used to ensure that access to \c _settings is exclusive.
      */
     QMutex _settingsMutex;
+
+    /*!
+     * \brief The revision of this Configuration, which is incremented whenever
+     * its contents are changed.
+     */
+    QAtomicInt _revision;
 };
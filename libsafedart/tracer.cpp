@@ -0,0 +1,203 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: tracer.cpp
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+
+#include "tracer.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QVector>
+
+namespace
+{
+    /*!
+     * \brief A single recorded trace event.
+     */
+    struct Event
+    {
+        char phase;
+        const char *category;
+        QByteArray name;
+        QByteArray detail;
+        qint64 timestamp;
+        int thread;
+    };
+
+    /*!
+     * \brief The state of the tracer, shared by all threads.
+     */
+    struct TraceState
+    {
+        QMutex mutex;
+        QElapsedTimer clock;
+        QVector<Event> events;
+        QAtomicInt nextThread;
+    };
+
+    TraceState &state()
+    {
+        static TraceState state;
+        return state;
+    }
+
+    /*!
+     * \brief Gets a small number identifying the current thread, which is
+     * easier to read in a trace viewer than a native thread ID.
+     */
+    int currentThread()
+    {
+        thread_local int thread = state().nextThread.fetchAndAddRelaxed(1) + 1;
+        return thread;
+    }
+}
+
+QAtomicInt Tracer::_enabled;
+
+// ********************************************************************** */
+Tracer::Span::Span(const char *category, const char *name, const char *detail) :
+    _category(nullptr)
+// ********************************************************************** */
+{
+    if (!Tracer::isEnabled())
+        return;
+
+    _category = category;
+    _name = name;
+    Tracer::begin(category, _name, QByteArray(detail));
+} // Tracer::Span::Span(const char *category, const char *name, const char *detail)
+
+// ********************************************************************** */
+Tracer::Span::~Span()
+// ********************************************************************** */
+{
+    // End the span even if tracing has been turned off since, so that the
+    // recorded events stay balanced
+    if (_category)
+        Tracer::record('E', _category, _name, QByteArray());
+} // Tracer::Span::~Span()
+
+// ********************************************************************** */
+void Tracer::start()
+// ********************************************************************** */
+{
+    TraceState &state = ::state();
+
+    QMutexLocker lock(&state.mutex);
+    Q_UNUSED(lock);
+
+    state.events.clear();
+    state.clock.start();
+    _enabled.storeRelease(1);
+} // void Tracer::start()
+
+// ********************************************************************** */
+void Tracer::stop()
+// ********************************************************************** */
+{
+    _enabled.storeRelease(0);
+} // void Tracer::stop()
+
+// ********************************************************************** */
+void Tracer::begin(const char *category, const QByteArray &name, const QByteArray &detail)
+// ********************************************************************** */
+{
+    if (isEnabled())
+        record('B', category, name, detail);
+} // void Tracer::begin(const char *category, const QByteArray &name, const QByteArray &detail)
+
+// ********************************************************************** */
+void Tracer::end(const char *category, const QByteArray &name)
+// ********************************************************************** */
+{
+    if (isEnabled())
+        record('E', category, name, QByteArray());
+} // void Tracer::end(const char *category, const QByteArray &name)
+
+// ********************************************************************** */
+QByteArray Tracer::toJson()
+// ********************************************************************** */
+{
+    TraceState &state = ::state();
+    qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray events;
+    {
+        QMutexLocker lock(&state.mutex);
+        Q_UNUSED(lock);
+
+        for (const Event &event : state.events)
+        {
+            QJsonObject object;
+            object.insert("ph", QString(QLatin1Char(event.phase)));
+            object.insert("cat", QString::fromUtf8(event.category));
+            object.insert("name", QString::fromUtf8(event.name));
+            object.insert("ts", double(event.timestamp) / 1000.0);
+            object.insert("pid", double(pid));
+            object.insert("tid", event.thread);
+            if (!event.detail.isEmpty())
+                object.insert("args", QJsonObject { { "detail", QString::fromUtf8(event.detail) } });
+
+            events.append(object);
+        }
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents", events);
+    trace.insert("displayTimeUnit", QString("ms"));
+    return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+} // QByteArray Tracer::toJson()
+
+// ********************************************************************** */
+bool Tracer::save(const QString &path)
+// ********************************************************************** */
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QByteArray json = toJson();
+    return file.write(json) == json.size();
+} // bool Tracer::save(const QString &path)
+
+// ********************************************************************** */
+void Tracer::record(char phase, const char *category, const QByteArray &name, const QByteArray &detail)
+// ********************************************************************** */
+{
+    TraceState &state = ::state();
+    int thread = currentThread();
+
+    QMutexLocker lock(&state.mutex);
+    Q_UNUSED(lock);
+
+    Event event = { phase, category, name, detail, state.clock.nsecsElapsed(), thread };
+    state.events.append(event);
+} // void Tracer::record(char phase, const char *category, const QByteArray &name, const QByteArray &detail)
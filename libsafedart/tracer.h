@@ -0,0 +1,169 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: tracer.h
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+#pragma once
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QString>
+
+/*!
+ * \brief Records a timeline of what SAFE-DART is doing, for viewing in Chrome's
+ * trace viewer or Perfetto.
+ *
+ * Tracing is off by default. While it is on, Builder records the construction
+ * of each object, and LibraryModuleLoader records the loading of each module,
+ * as a pair of begin and end events tagged with the current thread. Objects
+ * constructed while constructing another object appear nested inside it, so
+ * the slowest constructors on the critical path stand out.
+ *
+ * The recorded events can be saved in the Chrome trace-event JSON format,
+ * which can be opened at https://ui.perfetto.dev or chrome://tracing. The
+ * SAFE-DART executable does this when given the \c --trace option.
+ *
+ * While tracing is off, recording an event costs a single atomic load.
+ *
+ * \note Tracer is thread-safe.
+ *
+ * \ingroup SAFE-DART-Framework
+ */
+class Tracer
+{
+public:
+    /*!
+     * \brief Records the duration of the enclosing block as a pair of begin and
+     * end events.
+     */
+    class Span
+    {
+    public:
+        /*!
+         * \brief Records a begin event, if tracing is on.
+         *
+         * The name and detail are only copied if tracing is on, so a Span costs
+         * nothing else while it is off.
+         *
+         * \param category The category of the event, such as "builder".
+         * \param name The null-terminated name of the event.
+         * \param detail Additional information about the event, or null if
+         * there is none.
+         */
+        Span(const char *category, const char *name, const char *detail = nullptr);
+
+        /*!
+         * \brief Records the matching end event, if the begin event was
+         * recorded.
+         */
+        ~Span();
+
+    private:
+        Q_DISABLE_COPY(Span)
+
+        /*!
+         * \brief The category of the event, or null if no begin event was
+         * recorded.
+         */
+        const char *_category;
+
+        /*!
+         * \brief The name of the event.
+         */
+        QByteArray _name;
+    };
+
+    /*!
+     * \brief Discards any recorded events, and turns tracing on.
+     */
+    static void start();
+
+    /*!
+     * \brief Turns tracing off. Recorded events are kept.
+     */
+    static void stop();
+
+    /*!
+     * \brief Checks whether tracing is on.
+     *
+     * \retval true Tracing is on.
+     * \retval false Tracing is off.
+     */
+    static bool isEnabled() { return _enabled.loadAcquire(); }
+
+    /*!
+     * \brief Records a begin event, if tracing is on.
+     *
+     * Every begin event should be followed by an end event with the same
+     * category and name, on the same thread; Span does this automatically.
+     *
+     * \param category The category of the event, such as "builder".
+     * \param name The name of the event.
+     * \param detail Additional information about the event, if any.
+     */
+    static void begin(const char *category, const QByteArray &name, const QByteArray &detail = QByteArray());
+
+    /*!
+     * \brief Records an end event, if tracing is on.
+     *
+     * \param category The category of the matching begin event.
+     * \param name The name of the matching begin event.
+     */
+    static void end(const char *category, const QByteArray &name);
+
+    /*!
+     * \brief Gets the recorded events in the Chrome trace-event JSON format.
+     *
+     * \return A JSON document containing the recorded events.
+     */
+    static QByteArray toJson();
+
+    /*!
+     * \brief Saves the recorded events to a file in the Chrome trace-event JSON
+     * format.
+     *
+     * \param path The path of the file to write.
+     *
+     * \retval true The file was written.
+     * \retval false The file could not be written.
+     */
+    static bool save(const QString &path);
+
+private:
+    /*!
+     * \brief Records an event.
+     *
+     * \param phase The phase of the event: 'B' for begin, or 'E' for end.
+     * \param category The category of the event.
+     * \param name The name of the event.
+     * \param detail Additional information about the event, if any.
+     */
+    static void record(char phase, const char *category, const QByteArray &name, const QByteArray &detail);
+
+    /*!
+     * \brief Nonzero while tracing is on.
+     */
+    static QAtomicInt _enabled;
+};
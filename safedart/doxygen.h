@@ -22,6 +22,11 @@ safedart --file path/to/config.ini --section section ApplicationImpl
  * "ApplicationImpl". The flags specifying the config file and section are optional; they will
  * default to "safedart.ini" and "safedart" respectively.
  *
+ * Passing \c -t (or \c --trace) followed by a file path records the loading of each module and the
+ * construction of each object, and writes them to that file in the Chrome trace-event format when
+ * the application exits. The file can be opened at https://ui.perfetto.dev or chrome://tracing. See
+ * Tracer.
+ *
  * Within the specified section of the specified configuration file, \c safedart will use the
  * following configuration keys:
  *
@@ -29,4 +34,8 @@ safedart --file path/to/config.ini --section section ApplicationImpl
  * the working directory.
  * \li \@module_files - A comma-separated list of module files to load. Relative to the working
  * directory.
+ * \li \@prewarm - A comma-separated list of names to instantiate in parallel after modules are
+ * loaded and before the application is run. See Builder::prewarm().
+ * \li \@seal - If true, the Builder is sealed after prewarming and before the application is run,
+ * so that names are looked up without locking. See Builder::seal().
  */
@@ -35,6 +35,7 @@
 #include <configuration.h>
 #include <moduleloader.h>
 #include <safeconfiguration.h>
+#include <tracer.h>
 
 // ********************************************************************** */
 SafeApplication::SafeApplication(Builder *builder, QObject *parent) :
@@ -75,6 +76,13 @@ int SafeApplication::main(int argc, char **argv)
                                      "section", "safedart");
     parser.addOption(sectionOption);
 
+    QCommandLineOption traceOption(QStringList {"t", "trace"},
+                                   "The path of a file to which to write a trace of object "
+                                   "construction and module loading, in the Chrome trace-event "
+                                   "format.",
+                                   "trace");
+    parser.addOption(traceOption);
+
     QCoreApplication app(argc, argv);
     parser.process(app);
 
@@ -88,8 +96,12 @@ int SafeApplication::main(int argc, char **argv)
     QByteArray application = arguments[0].toLocal8Bit();
     QString file = parser.value(fileOption);
     QString section = parser.value(sectionOption);
+    QString trace = parser.value(traceOption);
     SafeConfiguration::setFile(file);
 
+    if (!trace.isEmpty())
+        Tracer::start();
+
     try
     {
         QSharedPointer<Configuration> configuration =
@@ -135,14 +147,46 @@ int SafeApplication::main(int argc, char **argv)
         qWarning("Failed to load modules: %s", e.what());
     }
 
+    QSharedPointer<Configuration> configuration = _builder->configuration();
+    if (configuration)
+    {
+        QList<QByteArray> names;
+        for (const QString &name : configuration->get(section + "/@prewarm").toStringList())
+            names.append(name.toUtf8());
+
+        if (!names.isEmpty())
+        {
+            int prewarmed = _builder->prewarm(names);
+            qDebug("%d of %d object(s) prewarmed.", prewarmed, names.size());
+        }
+
+        // Start-up is complete; freeze the bindings so that the application
+        // looks them up without locking
+        if (configuration->get(section + "/@seal", false).toBool())
+        {
+            names.append(application);
+            _builder->seal(names);
+            qDebug("Builder sealed.");
+        }
+    }
+
+    int result = 1;
     try
     {
         QSharedPointer<Application> app = _builder->get<Application>(application);
-        return app->main(argc, argv);
+        result = app->main(argc, argv);
     }
     catch(const QException &e)
     {
         qCritical("Failed to run Application: %s", e.what());
-        return 1;
     }
+
+    if (!trace.isEmpty())
+    {
+        Tracer::stop();
+        if (!Tracer::save(trace))
+            qWarning("Failed to write trace to %s.", trace.toLocal8Bit().constData());
+    }
+
+    return result;
 } // end int SafeApplication::main(int argc, char **argv)
@@ -0,0 +1,47 @@
+###################################################################### ##
+##
+## Developed for NASA Glenn Research Center
+## By: Flight Software Branch (LSS)
+##
+## Project: Flow Boiling and Condensation Experiment (FBCE)
+## Candidate for GOTS reuse once FBCE has completed V&V testing
+##
+## Filename: BenchmarkSafeDartBuilder.pro
+## File Date: 20261017
+##
+## Authors ##
+## Author: Flight Software Branch (LSS)
+##
+## Version and Traceability ##
+## Subversion: @version $Id$
+##
+## Revision History:
+##   <Date> <Name of Change Agent>
+##   Description:
+##     - Bulleted list of changes.
+##
+## Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+## No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+## See LICENSE.txt in the root of the repository for more details.
+## 
+###################################################################### ##
+
+QT       -= gui
+
+TARGET = bench_safedartbuilder
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += \
+    $$PWD/bench_safedartbuilder.cpp
+
+# Measure an optimized build, without the coverage instrumentation used by the
+# unit tests
+QMAKE_CXXFLAGS += --std=c++11
+QMAKE_CXXFLAGS += -O2
+
+INCLUDEPATH += $$PWD/../../libsafedart
+
+include($$PWD/../../libsafedart/libsafedart.pro)
@@ -0,0 +1,467 @@
+/* **********************************************************************
+**
+** Developed for NASA Glenn Research Center
+** By: Flight Software Branch (LSS)
+**
+** Project: Flow Boiling and Condensation Experiment (FBCE)
+** Candidate for GOTS reuse once FBCE has completed V&V testing
+**
+** Filename: bench_safedartbuilder.cpp
+** File Date: 20261017
+**
+** Authors **
+** Author: Flight Software Branch (LSS)
+**
+** Version and Traceability **
+** Subversion: @version $Id$
+**
+** Revision History:
+**   <Date> <Name of Change Agent>
+**   Description:
+**     - Bulleted list of changes.
+**
+** Copyright © 2017 United States Government as represented by NASA Glenn Research Center.
+** No copyright is claimed in the United States under Title 17, U.S.Code. All Other Rights Reserved.
+** See LICENSE.txt in the root of the repository for more details.
+**
+********************************************************************** */
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QVector>
+
+#include <algorithm>
+#include <cstdio>
+
+#include <builder.h>
+#include <memoryconfiguration.h>
+
+/*
+ * Measures Builder under concurrent load.
+ *
+ * Each scenario runs a number of threads against a single Builder. Every
+ * thread performs a fixed number of operations, chosen at random according to
+ * the scenario's mix:
+ *
+ *   get     - Gets an object. With probability equal to the hit ratio, a pinned
+ *             name is requested, whose object is kept alive for the whole run;
+ *             otherwise an unpinned name is requested, whose object is usually
+ *             constructed and then expires as soon as it is released.
+ *   provide - Provides a new object under an unpinned name, and holds on to it
+ *             for a while.
+ *   expire  - Releases the oldest object the thread is holding on to, so that
+ *             it expires.
+ *
+ * The throughput of each scenario, and the 50th and 99th percentile latency of
+ * its operations, are printed, and may be written to a JSON file. A file
+ * written by an earlier run may be given as a baseline, in which case each
+ * scenario is compared against the matching scenario in the baseline, and the
+ * benchmark fails if any has regressed by more than the tolerance.
+ */
+
+class BenchmarkObject : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE explicit BenchmarkObject(QObject *parent = 0) :
+        QObject(parent)
+    {
+    }
+};
+
+struct Scenario
+{
+    int threads;
+    int keys;
+    double hitRatio;
+    int getWeight;
+    int provideWeight;
+    int expireWeight;
+
+    QString mix() const
+    {
+        return QString("%1:%2:%3").arg(getWeight).arg(provideWeight).arg(expireWeight);
+    }
+
+    QString id() const
+    {
+        return QString("threads=%1 keys=%2 hit=%3 mix=%4").arg(threads).arg(keys).arg(hitRatio).arg(mix());
+    }
+};
+
+struct Result
+{
+    Scenario scenario;
+    qint64 operations;
+    double seconds;
+    double throughput;
+    double p50;
+    double p99;
+
+    QJsonObject toJson() const
+    {
+        QJsonObject object;
+        object.insert("id", scenario.id());
+        object.insert("threads", scenario.threads);
+        object.insert("keys", scenario.keys);
+        object.insert("hitRatio", scenario.hitRatio);
+        object.insert("mix", scenario.mix());
+        object.insert("operations", double(operations));
+        object.insert("seconds", seconds);
+        object.insert("throughput", throughput);
+        object.insert("p50", p50);
+        object.insert("p99", p99);
+        return object;
+    }
+};
+
+class WorkerThread : public QThread
+{
+public:
+    WorkerThread(Builder *builder, const Scenario &scenario, const QVector<QByteArray> &names,
+                 int operations, int seed, QAtomicInt *ready, QAtomicInt *go, QObject *parent = 0) :
+        QThread(parent),
+        builder(builder),
+        scenario(scenario),
+        names(names),
+        operations(operations),
+        state(quint64(seed) * 0x9E3779B97F4A7C15ull + 1),
+        ready(ready),
+        go(go)
+    {
+        latencies.reserve(operations);
+    }
+
+    QVector<qint64> latencies;
+
+protected:
+    void run() override
+    {
+        static const int HeldCapacity = 8;
+
+        QVector<QSharedPointer<QObject>> held;
+        held.reserve(HeldCapacity);
+
+        int pinned = names.size() / 2;
+        int totalWeight = scenario.getWeight + scenario.provideWeight + scenario.expireWeight;
+        quint64 hitThreshold = quint64(scenario.hitRatio * 1000000.0);
+
+        // Wait for every thread to be ready, so that they all start together
+        ready->ref();
+        while (!go->loadAcquire())
+            QThread::yieldCurrentThread();
+
+        QElapsedTimer timer;
+        for (int i = 0; i < operations; i++)
+        {
+            int choice = int(next() % quint64(totalWeight));
+            bool hit = next() % 1000000 < hitThreshold;
+            const QByteArray &pinnedName = names.at(int(next() % quint64(pinned)));
+            const QByteArray &unpinnedName = names.at(pinned + int(next() % quint64(names.size() - pinned)));
+
+            timer.start();
+            if (choice < scenario.getWeight)
+            {
+                builder->get(hit ? pinnedName.constData() : unpinnedName.constData());
+            }
+            else if (choice < scenario.getWeight + scenario.provideWeight)
+            {
+                if (held.size() == HeldCapacity)
+                    held.removeFirst();
+                held.append(QSharedPointer<QObject>(new BenchmarkObject));
+                builder->provide(unpinnedName.constData(), held.last());
+            }
+            else if (!held.isEmpty())
+            {
+                held.removeFirst();
+            }
+            else
+            {
+                // Nothing to expire; no operation ran, so there is no latency
+                // to record
+                continue;
+            }
+            latencies.append(timer.nsecsElapsed());
+        }
+    }
+
+    quint64 next()
+    {
+        // xorshift64*
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    Builder *builder;
+    Scenario scenario;
+    QVector<QByteArray> names;
+    int operations;
+    quint64 state;
+    QAtomicInt *ready;
+    QAtomicInt *go;
+};
+
+static double percentile(QVector<qint64> &samples, double fraction)
+{
+    if (samples.isEmpty())
+        return 0;
+
+    int index = qMin(samples.size() - 1, int(fraction * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return double(samples.at(index));
+}
+
+static Result run(const Scenario &scenario, int operations)
+{
+    QVector<QByteArray> names;
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    for (int i = 0; i < scenario.keys; i++)
+    {
+        names.append(QByteArray("Key") + QByteArray::number(i));
+        configuration->set(QString("safedart/") + names.last(), "BenchmarkObject");
+    }
+
+    Builder builder;
+    builder.setConfiguration(configuration);
+
+    // Keep the objects for the first half of the names alive throughout
+    QList<QSharedPointer<QObject>> pinned;
+    for (int i = 0; i < scenario.keys / 2; i++)
+        pinned.append(builder.get(names.at(i).constData()));
+
+    QAtomicInt ready;
+    QAtomicInt go;
+    QList<WorkerThread *> threads;
+    for (int i = 0; i < scenario.threads; i++)
+    {
+        threads.append(new WorkerThread(&builder, scenario, names, operations, i + 1, &ready, &go));
+        threads.last()->start();
+    }
+
+    while (ready.loadAcquire() < scenario.threads)
+        QThread::yieldCurrentThread();
+
+    QElapsedTimer wall;
+    wall.start();
+    go.storeRelease(1);
+
+    QVector<qint64> latencies;
+    for (WorkerThread *thread : threads)
+        thread->wait();
+    qint64 elapsed = wall.nsecsElapsed();
+
+    for (WorkerThread *thread : threads)
+        latencies += thread->latencies;
+    qDeleteAll(threads);
+
+    Result result;
+    result.scenario = scenario;
+    result.operations = latencies.size();
+    result.seconds = elapsed / 1e9;
+    result.throughput = result.seconds > 0 ? result.operations / result.seconds : 0;
+    result.p50 = percentile(latencies, 0.50);
+    result.p99 = percentile(latencies, 0.99);
+    return result;
+}
+
+template<typename T>
+static QList<T> parseList(const QString &value, bool *ok, T (*convert)(const QString &, bool *))
+{
+    QList<T> list;
+    for (const QString &item : value.split(',', QString::SkipEmptyParts))
+    {
+        list.append(convert(item.trimmed(), ok));
+        if (!*ok)
+            break;
+    }
+
+    *ok = *ok && !list.isEmpty();
+    return list;
+}
+
+static int toInt(const QString &value, bool *ok)
+{
+    int result = value.toInt(ok);
+    *ok = *ok && result > 0;
+    return result;
+}
+
+static double toRatio(const QString &value, bool *ok)
+{
+    double result = value.toDouble(ok);
+    *ok = *ok && result >= 0 && result <= 1;
+    return result;
+}
+
+static QString toMix(const QString &value, bool *ok)
+{
+    QStringList weights = value.split(':');
+    *ok = weights.size() == 3;
+
+    int total = 0;
+    for (int i = 0; *ok && i < weights.size(); i++)
+    {
+        int weight = weights.at(i).toInt(ok);
+        *ok = *ok && weight >= 0;
+        total += weight;
+    }
+
+    *ok = *ok && total > 0;
+    return value;
+}
+
+static QHash<QString, QJsonObject> readBaseline(const QString &path, bool *ok)
+{
+    QHash<QString, QJsonObject> baseline;
+
+    QFile file(path);
+    *ok = file.open(QIODevice::ReadOnly);
+    if (!*ok)
+        return baseline;
+
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    *ok = document.isObject();
+    for (const QJsonValue &value : document.object().value("results").toArray())
+    {
+        QJsonObject result = value.toObject();
+        baseline.insert(result.value("id").toString(), result);
+    }
+
+    return baseline;
+}
+
+static double change(double value, double baseline)
+{
+    return baseline > 0 ? (value - baseline) / baseline * 100.0 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    qRegisterMetaType<BenchmarkObject *>();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures the throughput and latency of Builder under concurrent load.");
+    parser.addHelpOption();
+
+    QCommandLineOption threadsOption("threads", "Comma-separated thread counts.", "counts", "1,2,4,8");
+    QCommandLineOption keysOption("keys", "Comma-separated numbers of names (at least 2).", "counts", "64,4096");
+    QCommandLineOption hitRatioOption("hit-ratio", "Comma-separated fractions of gets for pinned names.",
+                                      "ratios", "0.99,0.5");
+    QCommandLineOption mixOption("mix", "Comma-separated get:provide:expire weights.", "mixes", "100:0:0,90:5:5");
+    QCommandLineOption operationsOption("operations", "Operations per thread.", "count", "100000");
+    QCommandLineOption outputOption("output", "File to write the results to, as JSON.", "file");
+    QCommandLineOption baselineOption("baseline", "Results file of an earlier run to compare against.", "file");
+    QCommandLineOption toleranceOption("tolerance", "Percentage by which a scenario's throughput may fall, "
+                                       "or its p99 latency rise, before it counts as a regression.",
+                                       "percent", "10");
+    parser.addOptions({ threadsOption, keysOption, hitRatioOption, mixOption, operationsOption,
+                        outputOption, baselineOption, toleranceOption });
+    parser.process(app);
+
+    bool ok = true;
+    QList<int> threadCounts = parseList<int>(parser.value(threadsOption), &ok, toInt);
+    QList<int> keyCounts = ok ? parseList<int>(parser.value(keysOption), &ok, toInt) : QList<int>();
+    QList<double> hitRatios = ok ? parseList<double>(parser.value(hitRatioOption), &ok, toRatio) : QList<double>();
+    QList<QString> mixes = ok ? parseList<QString>(parser.value(mixOption), &ok, toMix) : QList<QString>();
+    int operations = ok ? toInt(parser.value(operationsOption), &ok) : 0;
+    double tolerance = ok ? parser.value(toleranceOption).toDouble(&ok) : 0;
+    for (int keys : keyCounts)
+        ok = ok && keys >= 2;
+    if (!ok)
+    {
+        qCritical("Invalid arguments; see --help.");
+        return 1;
+    }
+
+    QHash<QString, QJsonObject> baseline;
+    if (parser.isSet(baselineOption))
+    {
+        baseline = readBaseline(parser.value(baselineOption), &ok);
+        if (!ok)
+        {
+            qCritical("Failed to read baseline from %s.", qPrintable(parser.value(baselineOption)));
+            return 1;
+        }
+    }
+
+    QJsonArray results;
+    int regressions = 0;
+    for (const QString &mix : mixes)
+    {
+        QStringList weights = mix.split(':');
+        for (double hitRatio : hitRatios)
+        {
+            for (int keys : keyCounts)
+            {
+                for (int threads : threadCounts)
+                {
+                    Scenario scenario = { threads, keys, hitRatio, weights.at(0).toInt(),
+                                          weights.at(1).toInt(), weights.at(2).toInt() };
+                    Result result = run(scenario, operations);
+                    results.append(result.toJson());
+
+                    QString line = QString("%1: %2 ops/s, p50 %3 ns, p99 %4 ns")
+                            .arg(scenario.id())
+                            .arg(result.throughput, 0, 'f', 0)
+                            .arg(result.p50, 0, 'f', 0)
+                            .arg(result.p99, 0, 'f', 0);
+
+                    if (baseline.contains(scenario.id()))
+                    {
+                        QJsonObject previous = baseline.value(scenario.id());
+                        double throughputChange = change(result.throughput, previous.value("throughput").toDouble());
+                        double p99Change = change(result.p99, previous.value("p99").toDouble());
+                        bool regressed = throughputChange < -tolerance || p99Change > tolerance;
+                        if (regressed)
+                            regressions++;
+
+                        line += QString(" (throughput %1%2%, p99 %3%4%%5)")
+                                .arg(throughputChange >= 0 ? "+" : "").arg(throughputChange, 0, 'f', 1)
+                                .arg(p99Change >= 0 ? "+" : "").arg(p99Change, 0, 'f', 1)
+                                .arg(regressed ? ", REGRESSED" : "");
+                    }
+
+                    std::printf("%s\n", qPrintable(line));
+                    std::fflush(stdout);
+                }
+            }
+        }
+    }
+
+    if (parser.isSet(outputOption))
+    {
+        QJsonObject document;
+        document.insert("operationsPerThread", operations);
+        document.insert("results", results);
+
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+                || file.write(QJsonDocument(document).toJson()) < 0)
+        {
+            qCritical("Failed to write results to %s.", qPrintable(parser.value(outputOption)));
+            return 1;
+        }
+    }
+
+    if (regressions > 0)
+    {
+        std::printf("%d scenario(s) regressed by more than %g%%.\n", regressions, tolerance);
+        return 2;
+    }
+
+    return 0;
+}
+
+#include "bench_safedartbuilder.moc"
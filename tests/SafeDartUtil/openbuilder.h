@@ -34,9 +34,10 @@ class OpenBuilder : public Builder
 public:
     OpenBuilder(QObject *parent = 0);
 
+    using Builder::ConstructionPlan;
     using Builder::Instance;
     using Builder::_configuration;
     using Builder::_instances;
-    using Builder::_instancesMutex;
+    using Builder::_sealed;
     using Builder::_section;
 };
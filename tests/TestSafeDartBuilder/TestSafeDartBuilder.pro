@@ -33,6 +33,7 @@ TARGET = tst_testsafedartbuilder
 CONFIG   += console
 CONFIG   -= app_bundle
 CONFIG   += test
+CONFIG   += metrics
 
 TEMPLATE = app
 
@@ -26,13 +26,20 @@
 **
 ********************************************************************** */
 #include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QThread>
 #include <QUuid>
 #include <QtTest>
 
 #include <builder.h>
+#include <factoryregistry.h>
 #include <memoryconfiguration.h>
 #include <openbuilder.h>
+#include <reflectable.h>
+#include <sealedtable.h>
+#include <tracer.h>
 
 class TestSafeDartBuilder : public QObject
 {
@@ -41,26 +48,108 @@ class TestSafeDartBuilder : public QObject
 private slots:
     void init();
 
+    void testAtomIntern();
     void testConfiguration();
+    void testFactoryCreate();
+    void testFactoryCreateChanged();
+    void testFactoryCreateCircular();
+    void testFactoryCreateWrongType();
+    void testGetAllExisting();
+    void testGetAllNew();
+    void testGetAllTyped();
+    void testGetAllWithMissing();
+    void testGetAsyncExisting();
+    void testGetAsyncNew();
+    void testGetAsyncShared();
+    void testGetAsyncWithMissing();
+    void testGetAtom();
+    void testGetMultiCached();
+    void testGetMultiChanged();
+    void testGetMultiExpired();
+    void testGetMultiUnmapped();
     void testGetNewFromConfiguration();
+    void testGetNewInjected();
+    void testGetNewInjectedCircular();
+    void testGetNewInjectedPreferred();
     void testGetNewNotInvokable();
+    void testGetNewReflectable();
     void testGetNewWithBuilder();
     void testGetNewWithMissing();
     void testGetNewWithNone();
     void testGetRecursive();
+    void testGetResolutionCached();
+    void testGetResolutionChanged();
+    void testGetResolutionUnversioned();
     void testGetReplaceExpired();
+    void testGetReplaceExpiredUsesPlan();
+    void testGetTypedInterfaceCast();
     void testGetTypedNewCorrectType();
     void testGetTypedNewWrongType();
     void testGetUseConcurrent();
     void testGetUseExisting();
+    void testHandleGetExisting();
+    void testHandleGetReplaced();
+    void testHandleGetWrongType();
+    void testInstanceTableResize();
+    void testLazyGet();
+    void testLazyGetConcurrent();
+    void testLifecycleHookCreated();
+    void testLifecycleHookDestroying();
+    void testLifecycleHookRemoved();
+    void testMetrics();
+    void testPoolGetNotShared();
+    void testPoolGetReused();
+    void testPoolReleaseAfterBuilder();
+    void testPoolReleaseFull();
+    void testPoolSizePerName();
+    void testPrewarm();
+    void testPrewarmCycle();
+    void testPrewarmPooled();
+    void testPrewarmWithMissing();
     void testProvideAddNew();
     void testProvideReplaceExisting();
     void testProvideReplaceExpired();
+    void testReclaimConcurrent();
+    void testReclaimExpired();
+    void testReclaimKeepsInUse();
+    void testScopeDestroy();
+    void testScopeDestroyOutlived();
+    void testScopeGetFromParent();
+    void testScopeGetProvided();
+    void testScopeGetScoped();
+    void testSealCollidingHashes();
+    void testSealGet();
+    void testSealReclaimConcurrent();
+    void testSealRejectsChanges();
     void testSetConfiguration();
-
+    void testTraceNested();
+    void testTryGetExisting();
+    void testTryGetMissing();
+    void testTryGetNotInvokable();
+    void testTryGetUsesPlan();
+    void testTryGetWrongType();
+
+    void benchmarkFactoryCreate();
+    void benchmarkGetAllExisting_data();
+    void benchmarkGetAllExisting();
+    void benchmarkGetAtomExisting();
+    void benchmarkGetExisting_data();
     void benchmarkGetExisting();
+    void benchmarkGetExistingSealed_data();
+    void benchmarkGetExistingSealed();
+    void benchmarkGetSeveralExisting_data();
+    void benchmarkGetSeveralExisting();
     void benchmarkGetNew();
+    void benchmarkGetNewReflectable();
+    void benchmarkGetTypedExisting_data();
+    void benchmarkGetTypedExisting();
+    void benchmarkHandleGetExisting();
+    void benchmarkInstanceTableAdd_data();
+    void benchmarkInstanceTableAdd();
+    void benchmarkInstanceTableFind_data();
+    void benchmarkInstanceTableFind();
     void benchmarkProvide();
+    void benchmarkTryGetMissing();
 
 private:
     QScopedPointer<OpenBuilder> _builder;
@@ -100,6 +189,7 @@ public:
 };
 
 Q_DECLARE_INTERFACE(TestObjectInvokableWithBuilder, "TestObjectInvokableWithBuilder")
+SAFEDART_DECLARE_INJECTABLE(TestObjectInvokableWithBuilder)
 
 class TestObjectInvokableWithNone : public QObject
 {
@@ -113,6 +203,93 @@ public:
 };
 
 Q_DECLARE_INTERFACE(TestObjectInvokableWithNone, "TestObjectInvokableWithNone")
+SAFEDART_DECLARE_INJECTABLE(TestObjectInvokableWithNone)
+
+class TestObjectInjected : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE explicit TestObjectInjected(QObject *parent = 0) :
+        QObject(parent),
+        withBuilder(nullptr)
+    {
+    }
+
+    Q_INVOKABLE explicit TestObjectInjected(QSharedPointer<TestObjectInvokableWithNone> none,
+                                            TestObjectInvokableWithBuilder *withBuilder, QObject *parent = 0) :
+        QObject(parent),
+        none(none),
+        withBuilder(withBuilder)
+    {
+    }
+
+    QSharedPointer<TestObjectInvokableWithNone> none;
+    TestObjectInvokableWithBuilder *withBuilder;
+};
+
+Q_DECLARE_INTERFACE(TestObjectInjected, "TestObjectInjected")
+
+class TestObjectInjectedBuilderFirst : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE explicit TestObjectInjectedBuilderFirst(Builder *, QObject *parent = 0) :
+        QObject(parent)
+    {
+    }
+
+    Q_INVOKABLE explicit TestObjectInjectedBuilderFirst(QSharedPointer<TestObjectInvokableWithNone> none,
+                                                        QObject *parent = 0) :
+        QObject(parent),
+        none(none)
+    {
+    }
+
+    QSharedPointer<TestObjectInvokableWithNone> none;
+};
+
+Q_DECLARE_INTERFACE(TestObjectInjectedBuilderFirst, "TestObjectInjectedBuilderFirst")
+
+class TestObjectInjectedBuilderLast : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE explicit TestObjectInjectedBuilderLast(QSharedPointer<TestObjectInvokableWithNone> none,
+                                                       QObject *parent = 0) :
+        QObject(parent),
+        none(none)
+    {
+    }
+
+    Q_INVOKABLE explicit TestObjectInjectedBuilderLast(Builder *, QObject *parent = 0) :
+        QObject(parent)
+    {
+    }
+
+    QSharedPointer<TestObjectInvokableWithNone> none;
+};
+
+Q_DECLARE_INTERFACE(TestObjectInjectedBuilderLast, "TestObjectInjectedBuilderLast")
+
+class TestObjectCircular : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE explicit TestObjectCircular(QSharedPointer<TestObjectCircular> self, QObject *parent = 0) :
+        QObject(parent),
+        self(self)
+    {
+    }
+
+    QSharedPointer<TestObjectCircular> self;
+};
+
+Q_DECLARE_INTERFACE(TestObjectCircular, "TestObjectCircular")
+SAFEDART_DECLARE_INJECTABLE(TestObjectCircular)
 
 class TestObjectRecursive : public QObject
 {
@@ -130,16 +307,234 @@ public:
 
 Q_DECLARE_INTERFACE(TestObjectRecursive, "TestObjectRecursive")
 
+class TestObjectFactoryCircular : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE explicit TestObjectFactoryCircular(Builder *builder, QObject *parent = 0) :
+        QObject(parent)
+    {
+        child = builder->factory<TestObjectFactoryCircular>("TestObjectFactoryCircular").create();
+    }
+
+    QSharedPointer<TestObjectFactoryCircular> child;
+};
+
+Q_DECLARE_INTERFACE(TestObjectFactoryCircular, "TestObjectFactoryCircular")
+
+class TestObjectCycleFirst : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE explicit TestObjectCycleFirst(Builder *builder, QObject *parent = 0) :
+        QObject(parent)
+    {
+        other = builder->get("TestObjectCycleSecond");
+    }
+
+    QSharedPointer<QObject> other;
+};
+
+class TestObjectCycleSecond : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE explicit TestObjectCycleSecond(Builder *builder, QObject *parent = 0) :
+        QObject(parent)
+    {
+        other = builder->get("TestObjectCycleFirst");
+    }
+
+    QSharedPointer<QObject> other;
+};
+
+class TestObjectReflectable : public QObject, public Reflectable<TestObjectReflectable>
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE explicit TestObjectReflectable(Builder *builder, QObject *parent = 0) :
+        QObject(parent),
+        builder(builder)
+    {
+    }
+
+    Builder *builder;
+};
+
+class TestInterface
+{
+public:
+    virtual ~TestInterface() {}
+    virtual int value() const = 0;
+};
+
+Q_DECLARE_INTERFACE(TestInterface, "TestInterface")
+
+class TestObjectImplementing : public QObject, public TestInterface
+{
+    Q_OBJECT
+    Q_INTERFACES(TestInterface)
+
+public:
+    int value() const override { return 1; }
+};
+
+class TestObjectImplementingFirst : public TestInterface, public QObject
+{
+    Q_OBJECT
+    Q_INTERFACES(TestInterface)
+
+public:
+    int value() const override { return 2; }
+};
+
+class TestObjectPoolable : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE explicit TestObjectPoolable(QObject *parent = 0) :
+        QObject(parent),
+        used(false)
+    {
+    }
+
+    Q_INVOKABLE void reset()
+    {
+        used = false;
+    }
+
+    bool used;
+};
+
+Q_DECLARE_INTERFACE(TestObjectPoolable, "TestObjectPoolable")
+
+class RecordingHook : public LifecycleHook
+{
+public:
+    explicit RecordingHook(OpenBuilder *builder = nullptr) :
+        builder(builder),
+        unlocked(true)
+    {
+    }
+
+    void objectsCreated(Builder *, const QList<QSharedPointer<QObject>> &objects) override
+    {
+        created.append(objects);
+
+        // Hooks must not be called while any Instance is locked
+        if (builder)
+        {
+            for (const QSharedPointer<QObject> &object : objects)
+            {
+                QMutex &mutex = builder->_instances[object->metaObject()->className()]._referenceMutex;
+                unlocked = unlocked && mutex.tryLock();
+                if (unlocked)
+                    mutex.unlock();
+            }
+        }
+    }
+
+    void objectDestroying(Builder *, QObject *object) override
+    {
+        destroying.append(object);
+    }
+
+    OpenBuilder *builder;
+    QList<QList<QSharedPointer<QObject>>> created;
+    QList<QObject *> destroying;
+    bool unlocked;
+};
+
+class CountingConfiguration : public MemoryConfiguration
+{
+public:
+    explicit CountingConfiguration(QObject *parent = 0) :
+        MemoryConfiguration(parent),
+        gets(0)
+    {
+    }
+
+    QVariant get(const QString &key, const QVariant &defaultValue) override
+    {
+        gets++;
+        return MemoryConfiguration::get(key, defaultValue);
+    }
+
+    int gets;
+};
+
+class UnversionedConfiguration : public Configuration
+{
+public:
+    void clear() override { values.clear(); }
+    QVariant get(const QString &key, const QVariant &defaultValue) override { return values.value(key, defaultValue); }
+    void remove(const QString &key) override { values.remove(key); }
+    void set(const QString &key, const QVariant &value) override { values[key] = value; }
+
+    QHash<QString, QVariant> values;
+};
+
+class GetThread : public QThread
+{
+public:
+    GetThread(Builder *builder, const char *name, int count, QObject *parent = 0) :
+        QThread(parent),
+        builder(builder),
+        name(name),
+        count(count)
+    {
+    }
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < count; i++)
+            builder->get(name);
+    }
+
+    Builder *builder;
+    const char *name;
+    int count;
+};
+
 void TestSafeDartBuilder::init()
 {
     _builder.reset(new OpenBuilder);
 
+    qMetaTypeId<TestObjectCircular *>();
+    qMetaTypeId<TestObjectCycleFirst *>();
+    qMetaTypeId<TestObjectCycleSecond *>();
+    qMetaTypeId<TestObjectFactoryCircular *>();
+    qMetaTypeId<TestObjectInjected *>();
+    qMetaTypeId<TestObjectInjectedBuilderFirst *>();
+    qMetaTypeId<TestObjectInjectedBuilderLast *>();
     qMetaTypeId<TestObjectInvokableWithBuilder *>();
     qMetaTypeId<TestObjectInvokableWithNone *>();
     qMetaTypeId<TestObjectNotInvokable *>();
     qMetaTypeId<TestObjectRecursive *>();
 }
 
+void TestSafeDartBuilder::testAtomIntern()
+{
+    Atom atom("TestAtom");
+    QString string = "TestAtom";
+
+    QVERIFY2(!atom.isNull() && Atom().isNull(), "Atom has the wrong nullness");
+    QVERIFY2(atom == Atom(QByteArray("TestAtom")), "Atom was interned twice");
+    QVERIFY2(atom == Atom(string), "Atom was interned twice");
+    QVERIFY2(atom == Atom("TestAtomLonger", 8), "Atom was interned twice");
+    QVERIFY2(atom != Atom("TestAtomLonger"), "Different names were interned together");
+
+    QVERIFY2(atom.name() == "TestAtom" && atom.size() == 8, "Atom has the wrong name");
+    QVERIFY2(atom.toString() == string, "Atom has the wrong string");
+    QVERIFY2(atom.hash() == qHash(QByteArray("TestAtom")), "Atom has the wrong hash");
+}
+
 void TestSafeDartBuilder::testConfiguration()
 {
     QSharedPointer<Configuration> configuration(new MemoryConfiguration);
@@ -149,100 +544,519 @@ void TestSafeDartBuilder::testConfiguration()
     QVERIFY2(result == configuration, "Returned wrong object");
 }
 
-void TestSafeDartBuilder::testGetNewFromConfiguration()
+void TestSafeDartBuilder::testFactoryCreate()
 {
-    QString section = QUuid::createUuid().toString(); 
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/Test", "TestObjectInvokableWithBuilder");
+    _builder->setConfiguration(configuration);
+
+    Factory<TestObjectInvokableWithBuilder> factory = _builder->factory<TestObjectInvokableWithBuilder>("Test");
+
+    QSharedPointer<TestObjectInvokableWithBuilder> first = factory.create();
+    QSharedPointer<TestObjectInvokableWithBuilder> second = factory.create();
+    QVERIFY2(first && second, "Failed to create object");
+    QVERIFY2(first != second, "Factory did not create a new object");
+    QVERIFY2(first->builder == _builder.data(), "Object was not created with the Builder");
+    QVERIFY2(_builder->_instances["TestObjectInvokableWithBuilder"]._reference.isNull(), "Builder stored the created object");
+}
 
+void TestSafeDartBuilder::testFactoryCreateChanged()
+{
     QSharedPointer<Configuration> configuration(new MemoryConfiguration);
-    configuration->set(section + "/TestObject", "TestObjectInvokableWithNone");
-    _builder->setConfiguration(configuration, section);
+    configuration->set("safedart/Test", "TestObjectInvokableWithNone");
+    _builder->setConfiguration(configuration);
 
-    QSharedPointer<TestObjectInvokableWithNone> result = _builder
-            ->get("TestObject")
-            .objectCast<TestObjectInvokableWithNone>();
-    QVERIFY2(result, "Failed to create object");
+    Factory<QObject> factory = _builder->factory<QObject>("Test");
+    QVERIFY2(factory.create().objectCast<TestObjectInvokableWithNone>(), "Factory did not use the configuration");
+
+    configuration->set("safedart/Test", "TestObjectInvokableWithBuilder");
+    QVERIFY2(factory.create().objectCast<TestObjectInvokableWithBuilder>(), "Factory did not notice the configuration change");
 }
 
-void TestSafeDartBuilder::testGetNewNotInvokable()
+void TestSafeDartBuilder::testFactoryCreateCircular()
 {
-    QVERIFY_EXCEPTION_THROWN(_builder->get("TestObjectNotInvokable"), BuilderException);
+    // An object which creates itself through a Factory is reported, rather than
+    // recursing until the stack overflows
+    Factory<TestObjectFactoryCircular> factory = _builder->factory<TestObjectFactoryCircular>();
+    QVERIFY_EXCEPTION_THROWN(factory.create(), BuilderException);
 }
 
-void TestSafeDartBuilder::testGetNewWithBuilder()
+void TestSafeDartBuilder::testFactoryCreateWrongType()
 {
-    QSharedPointer<TestObjectInvokableWithBuilder> result = _builder
-            ->get("TestObjectInvokableWithBuilder")
-            .objectCast<TestObjectInvokableWithBuilder>();
+    Factory<TestObjectInvokableWithNone> factory = _builder->factory<TestObjectInvokableWithNone>("TestObjectInvokableWithBuilder");
 
-    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithBuilder"];
-    QSharedPointer<QObject> cached = instance._reference;
-    QVERIFY2(result, "Failed to create object");
-    QVERIFY2(result->builder == _builder.data(), "Object was not created with the Builder");
-    QVERIFY2(cached == result, "Builder did not store the created object");
+    QVERIFY_EXCEPTION_THROWN(factory.create(), BuilderException);
 }
 
-void TestSafeDartBuilder::testGetNewWithMissing()
+void TestSafeDartBuilder::testGetAllExisting()
 {
-    QVERIFY_EXCEPTION_THROWN(_builder->get<TestObjectInvokableWithNone>("TestObjectNonexistent"), BuilderException);
+    QSharedPointer<QObject> first = QSharedPointer<TestObjectInvokableWithNone>::create();
+    QSharedPointer<QObject> second = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->provide("First", first);
+    _builder->provide("Second", second);
+
+    QList<QSharedPointer<QObject>> result = _builder->getAll({ "Second", "First" });
+
+    QVERIFY2(result.size() == 2, "Builder did not return an object per name");
+    QVERIFY2(result.at(0) == second, "Builder did not use the existing object");
+    QVERIFY2(result.at(1) == first, "Builder did not use the existing object");
 }
 
-void TestSafeDartBuilder::testGetNewWithNone()
+void TestSafeDartBuilder::testGetAllNew()
 {
-    QSharedPointer<TestObjectInvokableWithNone> result = _builder
-            ->get("TestObjectInvokableWithNone")
-            .objectCast<TestObjectInvokableWithNone>();
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/Test", "TestObjectInvokableWithBuilder");
+    _builder->setConfiguration(configuration);
 
-    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
-    QSharedPointer<QObject> cached = instance._reference;
-    QVERIFY2(result, "Failed to create object");
-    QVERIFY2(cached == result, "Builder did not store the created object");
+    QList<QSharedPointer<QObject>> result = _builder
+            ->getAll({ "TestObjectInvokableWithNone", "Test", "TestObjectRecursive" });
+
+    QSharedPointer<QObject> none = _builder->_instances["TestObjectInvokableWithNone"]._reference;
+    QSharedPointer<QObject> builder = _builder->_instances["TestObjectInvokableWithBuilder"]._reference;
+    QSharedPointer<QObject> recursive = _builder->_instances["TestObjectRecursive"]._reference;
+    QVERIFY2(result.size() == 3, "Builder did not return an object per name");
+    QVERIFY2(result.at(0) && result.at(0) == none, "Builder did not store the created object");
+    QVERIFY2(result.at(1) && result.at(1) == builder, "Builder did not use the configuration");
+    QVERIFY2(result.at(2) && result.at(2) == recursive, "Builder did not store the created object");
+    QVERIFY2(recursive.objectCast<TestObjectRecursive>()->other == none, "Builder created a duplicate object");
 }
 
-void TestSafeDartBuilder::testGetRecursive()
+void TestSafeDartBuilder::testGetAllTyped()
 {
-    class RecursiveThread : public QThread
-    {
-    public:
-        RecursiveThread(Builder *builder, QObject *parent = 0) :
-            QThread(parent),
-            builder(builder)
-        {
-        }
+    QSharedPointer<TestObjectInvokableWithNone> none;
+    QSharedPointer<TestObjectInvokableWithBuilder> builder;
+    std::tie(none, builder) = _builder->getAll<TestObjectInvokableWithNone, TestObjectInvokableWithBuilder>();
 
-    protected:
-        void run() override
-        {
-            builder->get<TestObjectRecursive>();
-        }
+    QVERIFY2(none, "Builder did not create the first object");
+    QVERIFY2(builder, "Builder did not create the second object");
+    QVERIFY2(builder->builder == _builder.data(), "Builder did not use the correct constructor");
+}
 
-        Builder *builder;
-    } thread(_builder.data());
-    thread.start();
+void TestSafeDartBuilder::testGetAllWithMissing()
+{
+    QVERIFY_EXCEPTION_THROWN(_builder->getAll({ "TestObjectInvokableWithNone", "DoesNotExist" }), BuilderException);
+}
 
-    QVERIFY2(thread.wait(5000), "Getting objects from the Builder recursively caused a deadlock");;
+void TestSafeDartBuilder::testGetAsyncExisting()
+{
+    QSharedPointer<QObject> expected = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->provide("TestObjectInvokableWithNone", expected);
 
-    thread.terminate();
-    thread.wait();
+    QFuture<QSharedPointer<QObject>> future = _builder->getAsync("TestObjectInvokableWithNone");
+
+    QVERIFY2(future.isFinished(), "Builder waited for an existing object");
+    QVERIFY2(future.result() == expected, "Builder did not use the existing object");
 }
 
-void TestSafeDartBuilder::testGetReplaceExpired()
+void TestSafeDartBuilder::testGetAsyncNew()
 {
-    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
-    instance._reference = QWeakPointer<QObject>();
-
-    QSharedPointer<QObject> result = _builder
-            ->get("TestObjectInvokableWithNone")
-            .objectCast<TestObjectInvokableWithNone>();
+    QFuture<QSharedPointer<TestObjectInvokableWithBuilder>> future = _builder
+            ->getAsync<TestObjectInvokableWithBuilder>();
+    QSharedPointer<TestObjectInvokableWithBuilder> result = future.result();
 
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithBuilder"];
     QSharedPointer<QObject> cached = instance._reference;
     QVERIFY2(result, "Builder did not create a new object");
     QVERIFY2(cached == result, "Builder did not store the created object");
+    QVERIFY2(result->builder == _builder.data(), "Builder did not use the correct constructor");
 }
 
-void TestSafeDartBuilder::testGetTypedNewCorrectType()
+void TestSafeDartBuilder::testGetAsyncShared()
 {
-    QSharedPointer<TestObjectInvokableWithNone> result = _builder
-            ->get<TestObjectInvokableWithNone>();
+    QThreadPool pool;
+    pool.setMaxThreadCount(2);
+
+    // Hold up construction, so that the second request arrives while the
+    // first is still in progress
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
+    QMutexLocker lock(&instance._referenceMutex);
+
+    QFuture<QSharedPointer<QObject>> first = _builder->getAsync("TestObjectInvokableWithNone", &pool);
+    QFuture<QSharedPointer<QObject>> second = _builder->getAsync("TestObjectInvokableWithNone", &pool);
+
+    QVERIFY2(pool.activeThreadCount() == 1, "Builder started a second construction");
+
+    lock.unlock();
+
+    QVERIFY2(first.result(), "Builder did not create a new object");
+    QVERIFY2(first.result() == second.result(), "Requests did not share the construction");
+}
+
+void TestSafeDartBuilder::testGetAsyncWithMissing()
+{
+    QFuture<QSharedPointer<QObject>> future = _builder->getAsync("TestObjectMissing");
+
+    QVERIFY_EXCEPTION_THROWN(future.waitForFinished(), BuilderException);
+}
+
+void TestSafeDartBuilder::testGetAtom()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/TestObject", "TestObjectInvokableWithNone");
+    _builder->setConfiguration(configuration);
+
+    Atom name("TestObject");
+    QSharedPointer<TestObjectInvokableWithNone> first = _builder->get<TestObjectInvokableWithNone>(name);
+    QVERIFY2(first, "Failed to create object");
+    QVERIFY2(_builder->get("TestObject") == first, "Builder did not use existing object");
+    QVERIFY2(_builder->get(name) == first, "Builder did not use existing object");
+
+    // A name first requested by Atom shares the Atom's data, while a name first
+    // requested otherwise is still found
+    OpenBuilder::Instance &instance = _builder->_instances["TestObject"];
+    QVERIFY2(instance._name.constData() == name.constData(), "Instance did not share the Atom's name");
+
+    _builder->get("TestObjectInvokableWithNone");
+    QVERIFY2(_builder->get(Atom("TestObjectInvokableWithNone")) == first, "Builder did not use existing object");
+
+    // Sealed names are found by the Atom's hash as well
+    _builder->seal();
+    SealedTable *sealed = _builder->_sealed.load();
+    QVERIFY2(sealed->find(name) && sealed->find(name) == sealed->find("TestObject", 10),
+             "Sealed table did not find the Atom");
+    QVERIFY2(_builder->get(name) == first, "Builder did not use existing object");
+}
+
+void TestSafeDartBuilder::testGetMultiCached()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/Handler", QStringList { "TestObjectInvokableWithNone", "TestObjectInvokableWithBuilder" });
+    _builder->setConfiguration(configuration);
+
+    Builder::Collection first = _builder->getMulti("Handler");
+    QVERIFY2(first->size() == 2, "Builder did not return an object per binding");
+    QVERIFY2(first->at(0).objectCast<TestObjectInvokableWithNone>(), "Builder returned the objects out of order");
+    QVERIFY2(first->at(1).objectCast<TestObjectInvokableWithBuilder>(), "Builder returned the objects out of order");
+    QVERIFY2(first->at(0) == _builder->get("TestObjectInvokableWithNone"), "Builder created a duplicate object");
+
+    Builder::Collection second = _builder->getMulti("Handler");
+    QVERIFY2(second == first, "Builder did not reuse the collection");
+
+    QList<QSharedPointer<TestObjectInvokableWithNone>> single = _builder->getMulti<TestObjectInvokableWithNone>();
+    QVERIFY2(single.size() == 1, "Builder did not treat an unbound name as a list of itself");
+    QVERIFY2(single.first() == first->at(0), "Builder created a duplicate object");
+}
+
+void TestSafeDartBuilder::testGetMultiChanged()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/Handler", QStringList { "TestObjectInvokableWithNone", "TestObjectInvokableWithBuilder" });
+    _builder->setConfiguration(configuration);
+
+    Builder::Collection first = _builder->getMulti("Handler");
+    QVERIFY2(first->size() == 2, "Builder did not return an object per binding");
+
+    configuration->set("safedart/Handler", "TestObjectInvokableWithBuilder");
+
+    Builder::Collection second = _builder->getMulti("Handler");
+    QVERIFY2(second->size() == 1, "Builder did not notice the configuration change");
+    QVERIFY2(second->at(0) == first->at(1), "Builder created a duplicate object");
+
+    QSharedPointer<QObject> replacement = QSharedPointer<TestObjectInvokableWithBuilder>::create();
+    _builder->provide("TestObjectInvokableWithBuilder", replacement);
+
+    Builder::Collection third = _builder->getMulti("Handler");
+    QVERIFY2(third->at(0) == replacement, "Builder did not notice the provided object");
+}
+
+void TestSafeDartBuilder::testGetMultiExpired()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/Handler", QStringList { "TestObjectInvokableWithNone", "TestObjectInvokableWithBuilder" });
+    _builder->setConfiguration(configuration);
+
+    // The collection is rebuilt from its objects while they still exist
+    Builder::Collection first = _builder->getMulti("Handler");
+    QSharedPointer<QObject> none = first->at(0);
+    QWeakPointer<QObject> builder = first->at(1);
+    first.reset();
+
+    Builder::Collection second = _builder->getMulti("Handler");
+    QVERIFY2(second->at(0) == none, "Builder did not reuse the existing objects");
+    QVERIFY2(second->at(1) == builder, "Builder did not reuse the existing objects");
+
+    // Once any of them has expired, the objects are gotten again
+    second.reset();
+    QVERIFY2(builder.isNull(), "Builder kept an unused object alive");
+
+    Builder::Collection third = _builder->getMulti("Handler");
+    QVERIFY2(third->at(0) == none, "Builder did not reuse the existing object");
+    QVERIFY2(third->at(1).objectCast<TestObjectInvokableWithBuilder>(), "Builder did not replace the expired object");
+}
+
+void TestSafeDartBuilder::testGetMultiUnmapped()
+{
+    // Listed names are implementations, so are not mapped again
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/Handler", QStringList { "TestObjectInvokableWithNone", "TestObjectInvokableWithBuilder" });
+    configuration->set("safedart/TestObjectInvokableWithNone", "TestObjectInvokableWithBuilder");
+    _builder->setConfiguration(configuration);
+
+    Builder::Collection handlers = _builder->getMulti("Handler");
+    QVERIFY2(handlers->size() == 2, "Builder did not return an object per binding");
+    QVERIFY2(handlers->at(0).objectCast<TestObjectInvokableWithNone>(), "Builder mapped a listed name again");
+    QVERIFY2(handlers->at(1).objectCast<TestObjectInvokableWithBuilder>(), "Builder returned the objects out of order");
+
+    QVERIFY2(_builder->get("TestObjectInvokableWithNone") == handlers->at(1), "Builder did not map the name when requested");
+}
+
+void TestSafeDartBuilder::testGetNewFromConfiguration()
+{
+    QString section = QUuid::createUuid().toString(); 
+
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set(section + "/TestObject", "TestObjectInvokableWithNone");
+    _builder->setConfiguration(configuration, section);
+
+    QSharedPointer<TestObjectInvokableWithNone> result = _builder
+            ->get("TestObject")
+            .objectCast<TestObjectInvokableWithNone>();
+    QVERIFY2(result, "Failed to create object");
+}
+
+void TestSafeDartBuilder::testGetNewInjected()
+{
+    QList<QByteArray> dependencies = _builder->dependencies("TestObjectInjected");
+    QVERIFY2(dependencies.size() == 2, "Builder did not plan the injected objects");
+    QVERIFY2(dependencies.contains("TestObjectInvokableWithNone"), "Builder did not plan the injected objects");
+    QVERIFY2(dependencies.contains("TestObjectInvokableWithBuilder"), "Builder did not plan the injected objects");
+
+    QSharedPointer<TestObjectInjected> result = _builder->get<TestObjectInjected>();
+    QVERIFY2(result, "Failed to create object");
+
+    QSharedPointer<TestObjectInvokableWithNone> none = _builder->get<TestObjectInvokableWithNone>();
+    QSharedPointer<TestObjectInvokableWithBuilder> withBuilder = _builder->get<TestObjectInvokableWithBuilder>();
+    QVERIFY2(result->none == none, "Builder did not inject the shared object");
+    QVERIFY2(result->withBuilder == withBuilder.data(), "Builder did not inject the shared object");
+
+    // Objects injected by pointer live as long as the object they were
+    // injected into, held by a named child
+    QObject *holder = result->findChild<QObject *>(Builder::InjectedObjectsName, Qt::FindDirectChildrenOnly);
+    QVERIFY2(holder, "Builder did not name the child holding the injected objects");
+
+    withBuilder.reset();
+    QVERIFY2(!_builder->_instances["TestObjectInvokableWithBuilder"]._reference.isNull(), "Injected object was destroyed");
+
+    result.reset();
+    QVERIFY2(_builder->_instances["TestObjectInvokableWithBuilder"]._reference.isNull(), "Injected object was not released");
+}
+
+void TestSafeDartBuilder::testGetNewInjectedCircular()
+{
+    QVERIFY_EXCEPTION_THROWN(_builder->get<TestObjectCircular>(), BuilderException);
+}
+
+void TestSafeDartBuilder::testGetNewInjectedPreferred()
+{
+    // The injected constructor is used over T(Builder *), which takes as many
+    // parameters, whichever is declared first
+    QSharedPointer<TestObjectInjectedBuilderFirst> first = _builder->get<TestObjectInjectedBuilderFirst>();
+    QVERIFY2(first && first->none, "Builder did not use the injected constructor");
+
+    QSharedPointer<TestObjectInjectedBuilderLast> last = _builder->get<TestObjectInjectedBuilderLast>();
+    QVERIFY2(last && last->none, "Builder did not use the injected constructor");
+}
+
+void TestSafeDartBuilder::testGetNewNotInvokable()
+{
+    QVERIFY_EXCEPTION_THROWN(_builder->get("TestObjectNotInvokable"), BuilderException);
+}
+
+void TestSafeDartBuilder::testGetNewReflectable()
+{
+    QSharedPointer<QObject> result = _builder->get("TestObjectReflectable");
+    QSharedPointer<TestObjectReflectable> reflectable = result.objectCast<TestObjectReflectable>();
+    QVERIFY2(reflectable, "Failed to create object");
+    QVERIFY2(reflectable->builder == _builder.data(), "Object was not created with the Builder");
+    QVERIFY2(!reflectable->parent(), "Builder was passed as the object's parent");
+
+    const OpenBuilder::ConstructionPlan *plan = _builder->_instances["TestObjectReflectable"]._plan.loadAcquire();
+    QVERIFY2(plan && plan->factory, "Builder did not use the registered factory");
+
+    _builder->get("TestObjectInvokableWithNone");
+    plan = _builder->_instances["TestObjectInvokableWithNone"]._plan.loadAcquire();
+    QVERIFY2(plan && !plan->factory, "Unregistered type was given a factory");
+}
+
+void TestSafeDartBuilder::testGetNewWithBuilder()
+{
+    QSharedPointer<TestObjectInvokableWithBuilder> result = _builder
+            ->get("TestObjectInvokableWithBuilder")
+            .objectCast<TestObjectInvokableWithBuilder>();
+
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithBuilder"];
+    QSharedPointer<QObject> cached = instance._reference;
+    QVERIFY2(result, "Failed to create object");
+    QVERIFY2(result->builder == _builder.data(), "Object was not created with the Builder");
+    QVERIFY2(cached == result, "Builder did not store the created object");
+}
+
+void TestSafeDartBuilder::testGetNewWithMissing()
+{
+    QVERIFY_EXCEPTION_THROWN(_builder->get<TestObjectInvokableWithNone>("TestObjectNonexistent"), BuilderException);
+}
+
+void TestSafeDartBuilder::testGetNewWithNone()
+{
+    QSharedPointer<TestObjectInvokableWithNone> result = _builder
+            ->get("TestObjectInvokableWithNone")
+            .objectCast<TestObjectInvokableWithNone>();
+
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
+    QSharedPointer<QObject> cached = instance._reference;
+    QVERIFY2(result, "Failed to create object");
+    QVERIFY2(cached == result, "Builder did not store the created object");
+}
+
+void TestSafeDartBuilder::testGetRecursive()
+{
+    class RecursiveThread : public QThread
+    {
+    public:
+        RecursiveThread(Builder *builder, QObject *parent = 0) :
+            QThread(parent),
+            builder(builder)
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            builder->get<TestObjectRecursive>();
+        }
+
+        Builder *builder;
+    } thread(_builder.data());
+    thread.start();
+
+    QVERIFY2(thread.wait(5000), "Getting objects from the Builder recursively caused a deadlock");;
+
+    thread.terminate();
+    thread.wait();
+}
+
+void TestSafeDartBuilder::testGetResolutionCached()
+{
+    QSharedPointer<CountingConfiguration> configuration(new CountingConfiguration);
+    configuration->set("safedart/TestObject", "TestObjectInvokableWithNone");
+    _builder->setConfiguration(configuration);
+
+    QSharedPointer<QObject> first = _builder->get("TestObject");
+    QSharedPointer<QObject> second = _builder->get("TestObject");
+
+    QVERIFY2(first == second, "Builder did not use existing object");
+    QVERIFY2(configuration->gets == 1, "Builder did not cache the resolved name");
+
+    _builder->setConfiguration(configuration);
+    _builder->get("TestObject");
+
+    QVERIFY2(configuration->gets == 1, "Builder discarded resolved names for an unchanged configuration");
+}
+
+void TestSafeDartBuilder::testGetResolutionChanged()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/TestObject", "TestObjectInvokableWithNone");
+    _builder->setConfiguration(configuration);
+
+    QSharedPointer<QObject> first = _builder->get("TestObject");
+    QVERIFY2(first.objectCast<TestObjectInvokableWithNone>(), "Failed to create object");
+
+    configuration->set("safedart/TestObject", "TestObjectInvokableWithBuilder");
+
+    QSharedPointer<QObject> second = _builder->get("TestObject");
+    QVERIFY2(second.objectCast<TestObjectInvokableWithBuilder>(), "Builder did not notice the configuration change");
+
+    QString section = QUuid::createUuid().toString();
+    configuration->set(section + "/TestObject", "TestObjectInvokableWithNone");
+    _builder->setConfiguration(configuration, section);
+
+    QSharedPointer<QObject> third = _builder->get("TestObject");
+    QVERIFY2(third == first, "Builder did not notice the section change");
+}
+
+void TestSafeDartBuilder::testGetResolutionUnversioned()
+{
+    // A Configuration which does not track its revision is read on every get
+    QSharedPointer<UnversionedConfiguration> configuration(new UnversionedConfiguration);
+    configuration->set("safedart/TestObject", "TestObjectInvokableWithNone");
+    _builder->setConfiguration(configuration);
+
+    QSharedPointer<QObject> first = _builder->get("TestObject");
+    QVERIFY2(first.objectCast<TestObjectInvokableWithNone>(), "Failed to create object");
+
+    configuration->values["safedart/TestObject"] = "TestObjectInvokableWithBuilder";
+
+    QSharedPointer<QObject> second = _builder->get("TestObject");
+    QVERIFY2(second.objectCast<TestObjectInvokableWithBuilder>(), "Builder did not notice the configuration change");
+
+    // Sealing still settles on one stamp
+    _builder->seal();
+    QVERIFY2(_builder->get("TestObject") == second, "Builder did not use existing object");
+}
+
+void TestSafeDartBuilder::testGetReplaceExpired()
+{
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
+    instance._reference = QWeakPointer<QObject>();
+
+    QSharedPointer<QObject> result = _builder
+            ->get("TestObjectInvokableWithNone")
+            .objectCast<TestObjectInvokableWithNone>();
+
+    QSharedPointer<QObject> cached = instance._reference;
+    QVERIFY2(result, "Builder did not create a new object");
+    QVERIFY2(cached == result, "Builder did not store the created object");
+}
+
+void TestSafeDartBuilder::testGetReplaceExpiredUsesPlan()
+{
+    QSharedPointer<TestObjectInvokableWithBuilder> first = _builder
+            ->get("TestObjectInvokableWithBuilder")
+            .objectCast<TestObjectInvokableWithBuilder>();
+
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithBuilder"];
+    const OpenBuilder::ConstructionPlan *plan = instance._plan.loadAcquire();
+    QVERIFY2(plan, "Builder did not store a construction plan");
+    QVERIFY2(plan->metaObject == &TestObjectInvokableWithBuilder::staticMetaObject, "Plan has the wrong QMetaObject");
+    QVERIFY2(plan->takesBuilder, "Plan does not use T(Builder *)");
+
+    first.reset();
+
+    QSharedPointer<TestObjectInvokableWithBuilder> second = _builder
+            ->get("TestObjectInvokableWithBuilder")
+            .objectCast<TestObjectInvokableWithBuilder>();
+
+    QVERIFY2(second, "Builder did not create a new object");
+    QVERIFY2(second->builder == _builder.data(), "Object was not created with the Builder");
+    QVERIFY2(instance._plan.loadAcquire() == plan, "Builder did not reuse the construction plan");
+}
+
+void TestSafeDartBuilder::testGetTypedInterfaceCast()
+{
+    QSharedPointer<TestObjectImplementing> first = QSharedPointer<TestObjectImplementing>::create();
+    QSharedPointer<TestObjectImplementingFirst> second = QSharedPointer<TestObjectImplementingFirst>::create();
+    _builder->provide("First", first);
+    _builder->provide("Second", second);
+
+    // The interface lies at a different offset within each class, so switching
+    // between them must not reuse the other's cast
+    for (int i = 0; i < 2; i++)
+    {
+        QSharedPointer<TestInterface> firstCast = _builder->get<TestInterface>("First");
+        QSharedPointer<TestInterface> secondCast = _builder->get<TestInterface>("Second");
+        QVERIFY2(firstCast.data() == static_cast<TestInterface *>(first.data()), "Builder cast to the wrong address");
+        QVERIFY2(secondCast.data() == static_cast<TestInterface *>(second.data()), "Builder cast to the wrong address");
+        QVERIFY2(firstCast->value() == 1 && secondCast->value() == 2, "Builder cast to the wrong address");
+    }
+
+    QVERIFY_EXCEPTION_THROWN(_builder->get<TestObjectInvokableWithNone>("First"), BuilderException);
+}
+
+void TestSafeDartBuilder::testGetTypedNewCorrectType()
+{
+    QSharedPointer<TestObjectInvokableWithNone> result = _builder
+            ->get<TestObjectInvokableWithNone>();
 
     OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
     QSharedPointer<QObject> cached = instance._reference;
@@ -310,63 +1124,880 @@ void TestSafeDartBuilder::testGetUseExisting()
     QVERIFY2(initial == result, "Builder did not use existing object");
 }
 
-void TestSafeDartBuilder::testProvideAddNew()
+void TestSafeDartBuilder::testHandleGetExisting()
 {
-    QSharedPointer<QObject> given = QSharedPointer<TestObjectInvokableWithNone>::create();
-    _builder->provide("TestObjectInvokableWithNone", given);
+    QSharedPointer<TestObjectInvokableWithNone> initial = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->provide("TestObjectInvokableWithNone", initial);
 
-    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
-    QSharedPointer<QObject> result = instance._reference;
+    ServiceHandle<TestObjectInvokableWithNone> handle = _builder->handle<TestObjectInvokableWithNone>();
 
-    QVERIFY2(result == given, "Provide did not set new object");
+    QVERIFY2(handle.get() == initial, "Handle did not use existing object");
+    QVERIFY2(handle.get() == initial, "Handle did not reuse existing object");
 }
 
-void TestSafeDartBuilder::testProvideReplaceExisting()
+void TestSafeDartBuilder::testHandleGetReplaced()
 {
-    QSharedPointer<QObject> initial = QSharedPointer<TestObjectInvokableWithNone>::create();
-    QSharedPointer<QObject> replacement = QSharedPointer<TestObjectInvokableWithNone>::create();
+    ServiceHandle<TestObjectInvokableWithNone> handle = _builder->handle<TestObjectInvokableWithNone>();
 
-    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
-    instance._reference = initial;
+    QSharedPointer<TestObjectInvokableWithNone> created = handle.get();
+    QVERIFY2(created, "Handle did not create a new object");
 
+    QSharedPointer<TestObjectInvokableWithNone> replacement = QSharedPointer<TestObjectInvokableWithNone>::create();
     _builder->provide("TestObjectInvokableWithNone", replacement);
 
-    QSharedPointer<QObject> result = instance._reference;
-    QVERIFY2(result != initial, "Provide did not replace existing object");
-    QVERIFY2(result == replacement, "Provide did not set new object");
-}
-
-void TestSafeDartBuilder::testProvideReplaceExpired()
-{
-    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
-    instance._reference = QWeakPointer<QObject>();
+    QVERIFY2(handle.get() == replacement, "Handle did not follow the replaced object");
 
-    QSharedPointer<QObject> replacement = QSharedPointer<TestObjectInvokableWithNone>::create();
-    _builder->provide("TestObjectInvokableWithNone", replacement);
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/TestObjectInvokableWithNone", "TestObjectInvokableWithBuilder");
+    _builder->setConfiguration(configuration);
 
-    QSharedPointer<QObject> result = instance._reference;
-    QVERIFY2(result == replacement, "Provide did not set new object");
+    QVERIFY_EXCEPTION_THROWN(handle.get(), BuilderException);
 }
 
-void TestSafeDartBuilder::testSetConfiguration()
+void TestSafeDartBuilder::testHandleGetWrongType()
 {
-    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
-    QString section = QUuid::createUuid().toString();
+    ServiceHandle<TestObjectInvokableWithNone> handle = _builder->handle<TestObjectInvokableWithNone>("TestObjectInvokableWithBuilder");
 
-    _builder->setConfiguration(configuration, section);
-
-    QVERIFY2(_builder->_configuration == configuration, "Did not set configuration");
-    QVERIFY2(_builder->_section == section, "Did not set section");
+    QVERIFY_EXCEPTION_THROWN(handle.get(), BuilderException);
 }
 
-void TestSafeDartBuilder::benchmarkGetExisting()
+void TestSafeDartBuilder::testInstanceTableResize()
 {
-    QSharedPointer<TestObjectInvokableWithNone> existing = QSharedPointer<TestObjectInvokableWithNone>::create();
-    _builder->provide("TestObjectInvokableWithNone", existing);
+    // Enough names to resize every shard several times
+    InstanceTable table;
+    QList<QByteArray> names;
+    for (int i = 0; i < 20000; i++)
+    {
+        names.append(QByteArray("Device") + QByteArray::number(i));
+        InstanceTable::Instance &instance = table[names.last()];
+        QVERIFY2(instance._name == names.last(), "Table returned the wrong Instance");
+
+        // Names must stay reachable while shards are part way through moving
+        // to a larger array
+        if (i % 97 == 0)
+        {
+            for (int j = 0; j <= i; j += 13)
+                QVERIFY2(table.find(names.at(j)), "Name was lost while resizing");
+        }
+    }
+    QVERIFY2(table.size() == names.size(), "Table has the wrong size");
+
+    // Removed names are not found, and their slots are reused once shards are
+    // resized
+    QList<InstanceTable::Instance *> unlinked = table.unlink([](InstanceTable::Instance &instance)
+    {
+        return instance._name.endsWith('0');
+    });
+    QVERIFY2(unlinked.size() == names.size() / 10, "Table removed the wrong names");
+    qDeleteAll(unlinked);
+
+    for (int i = 0; i < 20000; i++)
+        table[QByteArray("Sensor") + QByteArray::number(i)];
+
+    for (const QByteArray &name : names)
+    {
+        bool found = table.find(name);
+        QVERIFY2(found != name.endsWith('0'), "Table found a removed name, or lost another");
+    }
+    QVERIFY2(table.size() == names.size() * 9 / 10 + 20000, "Table has the wrong size");
+    QVERIFY2(table.instances().size() == table.size(), "Table listed the wrong Instances");
+}
+
+void TestSafeDartBuilder::testLazyGet()
+{
+    Lazy<TestObjectInvokableWithNone> lazy = _builder->lazy<TestObjectInvokableWithNone>();
+    Lazy<TestObjectInvokableWithNone> copy = lazy;
+
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
+    QVERIFY2(!instance._reference.toStrongRef(), "Builder created the object before it was used");
+    QVERIFY2(!lazy.isResolved(), "Proxy was resolved before it was used");
+
+    QSharedPointer<TestObjectInvokableWithNone> result = copy.get();
+    QVERIFY2(result, "Proxy did not get the object");
+    QVERIFY2(lazy.isResolved(), "Copies of the proxy did not share the object");
+    QVERIFY2(lazy.get() == result, "Copies of the proxy did not share the object");
+    QVERIFY2(instance._reference.toStrongRef() == result, "Proxy did not get the object from the Builder");
+}
+
+void TestSafeDartBuilder::testLazyGetConcurrent()
+{
+    class LazyThread : public QThread
+    {
+    public:
+        LazyThread(Lazy<TestObjectInvokableWithNone> lazy, QObject *parent = 0) :
+            QThread(parent),
+            lazy(lazy)
+        {
+        }
+
+        QSharedPointer<TestObjectInvokableWithNone> result;
+
+    protected:
+        void run() override
+        {
+            result = lazy.get();
+        }
+
+        Lazy<TestObjectInvokableWithNone> lazy;
+    };
+
+    Lazy<TestObjectInvokableWithNone> lazy = _builder->lazy<TestObjectInvokableWithNone>();
+
+    int createdCount = 0;
+    connect(_builder.data(), &Builder::createdObject, [&createdCount]()
+    {
+        createdCount++;
+    });
+
+    QList<LazyThread *> threads;
+    for (int i = 0; i < 8; i++)
+        threads.append(new LazyThread(lazy));
+
+    for (LazyThread *thread : threads)
+        thread->start();
+    for (LazyThread *thread : threads)
+        thread->wait();
+
+    QVERIFY2(createdCount == 1, "Proxy got the object more than once");
+    for (LazyThread *thread : threads)
+        QVERIFY2(thread->result && thread->result == lazy.get(), "Threads saw different objects");
+
+    qDeleteAll(threads);
+}
+
+void TestSafeDartBuilder::testLifecycleHookCreated()
+{
+    RecordingHook hook(_builder.data());
+    _builder->addLifecycleHook(&hook);
+
+    QSharedPointer<TestObjectRecursive> result = _builder->get<TestObjectRecursive>();
+
+    QVERIFY2(hook.created.size() == 1, "Hook was not called once for the batch");
+    QVERIFY2(hook.created.first().size() == 2, "Hook was not given every created object");
+    QVERIFY2(hook.created.first().at(0) == result->other, "Hook was not given objects in order of creation");
+    QVERIFY2(hook.created.first().at(1) == result, "Hook was not given objects in order of creation");
+    QVERIFY2(hook.unlocked, "Hook was called while an Instance was locked");
+
+    _builder->removeLifecycleHook(&hook);
+}
+
+void TestSafeDartBuilder::testLifecycleHookDestroying()
+{
+    RecordingHook hook;
+    _builder->addLifecycleHook(&hook);
+
+    QSharedPointer<QObject> result = _builder->get("TestObjectInvokableWithNone");
+    QObject *object = result.data();
+    result.clear();
+
+    QVERIFY2(hook.destroying.size() == 1 && hook.destroying.first() == object, "Hook was not told about the destroyed object");
+
+    _builder->removeLifecycleHook(&hook);
+}
+
+void TestSafeDartBuilder::testLifecycleHookRemoved()
+{
+    RecordingHook hook;
+    _builder->addLifecycleHook(&hook);
+    _builder->removeLifecycleHook(&hook);
+
+    _builder->get("TestObjectInvokableWithNone");
+
+    QVERIFY2(hook.created.isEmpty(), "Removed hook was called");
+    QVERIFY2(hook.destroying.isEmpty(), "Removed hook was called");
+}
+
+void TestSafeDartBuilder::testMetrics()
+{
+#ifdef SAFEDART_METRICS
+    QSharedPointer<QObject> first = _builder->get("TestObjectInvokableWithNone");
+    QSharedPointer<QObject> second = _builder->get("TestObjectInvokableWithNone");
+
+    QList<BindingMetrics::Snapshot> snapshots = _builder->metrics();
+    QVERIFY2(snapshots.size() == 1, "Builder did not report metrics for the name");
+
+    BindingMetrics::Snapshot snapshot = snapshots.first();
+    QVERIFY2(snapshot.name == "TestObjectInvokableWithNone", "Builder reported the wrong name");
+    QVERIFY2(snapshot.gets == 2, "Builder did not count gets");
+    QVERIFY2(snapshot.hits == 1 && snapshot.misses == 1, "Builder did not count hits and misses");
+    QVERIFY2(snapshot.live == 1, "Builder did not count the live object");
+    QVERIFY2(snapshot.getLatency.count == 2, "Builder did not time gets");
+    QVERIFY2(snapshot.constructionTime.count == 1, "Builder did not time construction");
+    QVERIFY2(snapshot.lockWait.count == 1, "Builder did not time the lock wait");
+
+    first.clear();
+    second.clear();
+    QVERIFY2(_builder->metrics().first().live == 0, "Builder did not count the destroyed object");
+#else
+    QSharedPointer<QObject> object = _builder->get("TestObjectInvokableWithNone");
+    QVERIFY2(!_builder->_instances["TestObjectInvokableWithNone"]._metrics.loadAcquire(),
+             "Builder allocated metrics while they were disabled");
+    QVERIFY2(_builder->metrics().isEmpty(), "Builder reported metrics while they were disabled");
+#endif
+}
+
+void TestSafeDartBuilder::testPoolGetNotShared()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/@pooled", QStringList { "TestObjectPoolable" });
+    _builder->setConfiguration(configuration);
+
+    QSharedPointer<TestObjectPoolable> first = _builder->get<TestObjectPoolable>();
+    QSharedPointer<TestObjectPoolable> second = _builder->get<TestObjectPoolable>();
+
+    QVERIFY2(first && second, "Builder did not create pooled objects");
+    QVERIFY2(first != second, "Builder shared a pooled object");
+}
+
+void TestSafeDartBuilder::testPoolGetReused()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/@pooled", QStringList { "TestObjectPoolable" });
+    _builder->setConfiguration(configuration);
+
+    QSharedPointer<TestObjectPoolable> object = _builder->get<TestObjectPoolable>();
+    TestObjectPoolable *released = object.data();
+    object->used = true;
+    object.clear();
+
+    object = _builder->get<TestObjectPoolable>();
+    QVERIFY2(object.data() == released, "Builder did not reuse the pooled object");
+    QVERIFY2(!object->used, "Builder did not reset the pooled object");
+
+    InstancePool::Statistics statistics = _builder->poolStatistics("TestObjectPoolable");
+    QVERIFY2(statistics.acquisitions == 2, "Pool did not count acquisitions");
+    QVERIFY2(statistics.hits == 1, "Pool did not count hits");
+    QVERIFY2(statistics.size == 0, "Pool did not hand out its idle object");
+    QVERIFY2(statistics.highWaterMark == 1, "Pool did not record its high-water mark");
+}
+
+void TestSafeDartBuilder::testPoolReleaseAfterBuilder()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/@pooled", QStringList { "TestObjectPoolable" });
+    _builder->setConfiguration(configuration);
+
+    QSharedPointer<TestObjectPoolable> held = _builder->get<TestObjectPoolable>();
+    QPointer<TestObjectPoolable> object = held.data();
+
+    // The pool is destroyed along with the Builder, so a later release
+    // deletes the object instead
+    _builder.reset();
+    held.clear();
+    QVERIFY2(!object, "Object released after its Builder was not deleted");
+}
+
+void TestSafeDartBuilder::testPoolReleaseFull()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/@pooled", QStringList { "TestObjectPoolable" });
+    configuration->set("safedart/@pool_size", 1);
+    _builder->setConfiguration(configuration);
+
+    QSharedPointer<TestObjectPoolable> first = _builder->get<TestObjectPoolable>();
+    QSharedPointer<TestObjectPoolable> second = _builder->get<TestObjectPoolable>();
+    QPointer<TestObjectPoolable> extra = second.data();
+    first.clear();
+    second.clear();
+
+    InstancePool::Statistics statistics = _builder->poolStatistics("TestObjectPoolable");
+    QVERIFY2(statistics.capacity == 1, "Pool did not use the configured size");
+    QVERIFY2(statistics.size == 1, "Pool held more objects than its size");
+    QVERIFY2(extra.isNull(), "Builder did not delete the object which did not fit");
+}
+
+void TestSafeDartBuilder::testPoolSizePerName()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/@pooled", QStringList { "TestObjectPoolable", "TestObjectInvokableWithNone" });
+    configuration->set("safedart/@pool_size", 2);
+    configuration->set("safedart/TestObjectPoolable/@pool_size", 5);
+    _builder->setConfiguration(configuration);
+
+    _builder->get<TestObjectPoolable>();
+    _builder->get<TestObjectInvokableWithNone>();
+
+    InstancePool::Statistics named = _builder->poolStatistics("TestObjectPoolable");
+    InstancePool::Statistics defaulted = _builder->poolStatistics("TestObjectInvokableWithNone");
+    QVERIFY2(named.capacity == 5, "Pool did not use the size configured for its name");
+    QVERIFY2(defaulted.capacity == 2, "Pool did not fall back to the section's size");
+}
+
+void TestSafeDartBuilder::testPrewarm()
+{
+    int prewarmed = _builder->prewarm(QList<QByteArray> { "TestObjectRecursive", "TestObjectInvokableWithBuilder" });
+    QVERIFY2(prewarmed == 2, "Builder did not prewarm both objects");
+
+    QSharedPointer<QObject> recursive = _builder->_instances["TestObjectRecursive"]._reference;
+    QSharedPointer<QObject> withBuilder = _builder->_instances["TestObjectInvokableWithBuilder"]._reference;
+    QVERIFY2(recursive, "Builder did not keep the prewarmed object alive");
+    QVERIFY2(withBuilder, "Builder did not keep the prewarmed object alive");
+
+    QList<QByteArray> dependencies = _builder->dependencies("TestObjectRecursive");
+    QVERIFY2(dependencies == QList<QByteArray> { "TestObjectInvokableWithNone" }, "Builder did not observe the dependency");
+    QVERIFY2(_builder->dependencies("TestObjectInvokableWithBuilder").isEmpty(), "Builder observed a nonexistent dependency");
+
+    QVERIFY2(_builder->get("TestObjectRecursive") == recursive, "Builder did not use the prewarmed object");
+
+    // Once requested, a prewarmed object is kept alive only by its users
+    recursive.reset();
+    withBuilder.reset();
+    QVERIFY2(_builder->_instances["TestObjectRecursive"]._reference.isNull(), "Builder kept the requested object alive");
+    QVERIFY2(!_builder->_instances["TestObjectInvokableWithBuilder"]._reference.isNull(),
+             "Builder did not keep the prewarmed object alive");
+}
+
+void TestSafeDartBuilder::testPrewarmCycle()
+{
+    // Record the cycle: each object's constructor requests the other
+    QVERIFY_EXCEPTION_THROWN(_builder->get("TestObjectCycleFirst"), BuilderException);
+    QVERIFY2(_builder->dependencies("TestObjectCycleFirst") == QList<QByteArray> { "TestObjectCycleSecond" },
+             "Builder did not observe the dependency");
+    QVERIFY2(_builder->dependencies("TestObjectCycleSecond") == QList<QByteArray> { "TestObjectCycleFirst" },
+             "Builder did not observe the dependency");
+
+    // Neither object is ever ready; prewarming them must skip both rather
+    // than wait forever
+    int prewarmed = _builder->prewarm(QList<QByteArray> { "TestObjectCycleFirst", "TestObjectCycleSecond" }, 2);
+    QVERIFY2(prewarmed == 0, "Builder prewarmed an object with a circular dependency");
+}
+
+void TestSafeDartBuilder::testPrewarmPooled()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/@pooled", QStringList { "TestObjectPoolable" });
+    _builder->setConfiguration(configuration);
+
+    int prewarmed = _builder->prewarm(QList<QByteArray> { "TestObjectPoolable" });
+    QVERIFY2(prewarmed == 1, "Builder did not prewarm the pooled object");
+
+    InstancePool::Statistics statistics = _builder->poolStatistics("TestObjectPoolable");
+    QVERIFY2(statistics.size == 1, "Builder did not release the prewarmed object into its pool");
+}
+
+void TestSafeDartBuilder::testPrewarmWithMissing()
+{
+    int prewarmed = _builder->prewarm(QList<QByteArray> { "TestObjectNonexistent", "TestObjectInvokableWithNone" }, 1);
+    QVERIFY2(prewarmed == 1, "Builder did not skip the missing object");
+
+    QVERIFY_EXCEPTION_THROWN(_builder->get("TestObjectNonexistent"), BuilderException);
+}
+
+void TestSafeDartBuilder::testProvideAddNew()
+{
+    QSharedPointer<QObject> given = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->provide("TestObjectInvokableWithNone", given);
+
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
+    QSharedPointer<QObject> result = instance._reference;
+
+    QVERIFY2(result == given, "Provide did not set new object");
+}
+
+void TestSafeDartBuilder::testProvideReplaceExisting()
+{
+    QSharedPointer<QObject> initial = QSharedPointer<TestObjectInvokableWithNone>::create();
+    QSharedPointer<QObject> replacement = QSharedPointer<TestObjectInvokableWithNone>::create();
+
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
+    instance._reference = initial;
+
+    _builder->provide("TestObjectInvokableWithNone", replacement);
+
+    QSharedPointer<QObject> result = instance._reference;
+    QVERIFY2(result != initial, "Provide did not replace existing object");
+    QVERIFY2(result == replacement, "Provide did not set new object");
+}
+
+void TestSafeDartBuilder::testProvideReplaceExpired()
+{
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
+    instance._reference = QWeakPointer<QObject>();
+
+    QSharedPointer<QObject> replacement = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->provide("TestObjectInvokableWithNone", replacement);
+
+    QSharedPointer<QObject> result = instance._reference;
+    QVERIFY2(result == replacement, "Provide did not set new object");
+}
+
+void TestSafeDartBuilder::testReclaimConcurrent()
+{
+    QList<GetThread *> threads;
+    for (int i = 0; i < 4; i++)
+        threads.append(new GetThread(_builder.data(), "TestObjectInvokableWithNone", 2000));
+    for (GetThread *thread : threads)
+        thread->start();
+
+    bool running = true;
+    while (running)
+    {
+        _builder->reclaim();
+
+        running = false;
+        for (GetThread *thread : threads)
+            running = running || !thread->isFinished();
+    }
+
+    for (GetThread *thread : threads)
+        thread->wait();
+    qDeleteAll(threads);
+
+    _builder->reclaim();
+    QVERIFY2(_builder->instanceStatistics().size == 0, "Expired name was not reclaimed");
+    QVERIFY2(_builder->get("TestObjectInvokableWithNone"), "Reclaimed name could not be gotten again");
+}
+
+void TestSafeDartBuilder::testReclaimExpired()
+{
+    QSharedPointer<QObject> kept = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->provide("Kept", kept);
+
+    for (int i = 0; i < 8; i++)
+    {
+        QByteArray name = QByteArray("Expired") + QByteArray::number(i);
+        _builder->provide(name.constData(), QSharedPointer<TestObjectInvokableWithNone>::create());
+    }
+
+    QVERIFY2(_builder->instanceStatistics().size == 9, "Names were not added");
+    QVERIFY2(_builder->reclaim() == 8, "Did not reclaim every expired name");
+
+    InstanceTable::Statistics statistics = _builder->instanceStatistics();
+    QVERIFY2(statistics.size == 1, "Table size was not reduced");
+    QVERIFY2(statistics.reclaimed == 8, "Reclaimed names were not counted");
+    QVERIFY2(statistics.reclaims == 1, "Reclaim was not counted");
+    QVERIFY2(!_builder->_instances.find("Expired0"), "Expired name is still in the table");
+    QVERIFY2(_builder->get("Kept") == kept, "Live name was reclaimed");
+
+    _builder->provide("Expired0", kept);
+    QVERIFY2(_builder->get("Expired0") == kept, "Reclaimed name could not be provided again");
+}
+
+void TestSafeDartBuilder::testReclaimKeepsInUse()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/Mapped", "TestObjectInvokableWithNone");
+    configuration->set("safedart/Handled", "TestObjectInvokableWithNone");
+    configuration->set("safedart/@pooled", QStringList { "TestObjectPoolable" });
+    _builder->setConfiguration(configuration);
+
+    _builder->get("Mapped");
+    _builder->get<TestObjectPoolable>();
+    ServiceHandle<TestObjectInvokableWithNone> handle = _builder->handle<TestObjectInvokableWithNone>("Handled");
+    handle.get();
+
+    _builder->reclaim();
+
+    QVERIFY2(!_builder->_instances.find("Mapped"), "Unused name was not reclaimed");
+    QVERIFY2(_builder->_instances.find("TestObjectInvokableWithNone"), "Reclaimed a name which another name resolves to");
+    QVERIFY2(_builder->_instances.find("TestObjectPoolable"), "Reclaimed a pooled name");
+    QVERIFY2(_builder->_instances.find("Handled"), "Reclaimed a name with a ServiceHandle");
+    QVERIFY2(handle.get(), "ServiceHandle did not survive reclaim");
+
+    handle = ServiceHandle<TestObjectInvokableWithNone>();
+    _builder->reclaim();
+
+    QVERIFY2(!_builder->_instances.find("Handled"), "Name was not reclaimed once its ServiceHandle was released");
+}
+
+void TestSafeDartBuilder::testScopeDestroy()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/@scoped", QStringList { "TestObjectInvokableWithBuilder", "TestObjectInvokableWithNone" });
+    _builder->setConfiguration(configuration);
+
+    QSharedPointer<Builder> scope = _builder->createScope();
+    QPointer<QObject> first = scope->get("TestObjectInvokableWithBuilder").data();
+    QPointer<QObject> second = scope->get("TestObjectInvokableWithNone").data();
+    QObject *last = second.data();
+
+    QVERIFY2(first && second, "Scope did not keep its objects alive");
+
+    QList<QObject *> destroyed;
+    connect(scope.data(), &Builder::destroyingObject, [&destroyed](QObject *object)
+    {
+        destroyed.append(object);
+    });
+    scope.clear();
+
+    QVERIFY2(!first && !second, "Scope did not destroy its objects");
+    QVERIFY2(destroyed.size() == 2 && destroyed.first() == last, "Scope did not destroy its objects in reverse order");
+}
+
+void TestSafeDartBuilder::testScopeDestroyOutlived()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/@scoped", QStringList { "TestObjectInvokableWithNone" });
+    _builder->setConfiguration(configuration);
+
+    RecordingHook hook;
+    QSharedPointer<Builder> scope = _builder->createScope();
+    scope->addLifecycleHook(&hook);
+
+    QSharedPointer<QObject> held = scope->get("TestObjectInvokableWithNone");
+    QPointer<QObject> object = held.data();
+    scope.clear();
+    QVERIFY2(object, "Scope destroyed an object which was still held");
+
+    // The object no longer reports to the destroyed scope or its hooks
+    held.clear();
+    QVERIFY2(!object, "Object was not destroyed once released");
+    QVERIFY2(hook.destroying.isEmpty(), "Object reported to its destroyed scope");
+}
+
+void TestSafeDartBuilder::testScopeGetFromParent()
+{
+    QSharedPointer<QObject> expected = _builder->get("TestObjectInvokableWithNone");
+
+    QSharedPointer<Builder> scope = _builder->createScope();
+    QSharedPointer<QObject> result = scope->get("TestObjectInvokableWithNone");
+
+    QVERIFY2(result == expected, "Scope did not use its parent's object");
+}
+
+void TestSafeDartBuilder::testScopeGetProvided()
+{
+    QSharedPointer<QObject> parentObject = _builder->get("TestObjectInvokableWithNone");
+    QSharedPointer<QObject> scopeObject = QSharedPointer<TestObjectInvokableWithNone>::create();
+
+    QSharedPointer<Builder> scope = _builder->createScope();
+    scope->provide("TestObjectInvokableWithNone", scopeObject);
+
+    QVERIFY2(scope->get("TestObjectInvokableWithNone") == scopeObject, "Scope did not use its provided object");
+    QVERIFY2(_builder->get("TestObjectInvokableWithNone") == parentObject, "Providing to a scope changed its parent");
+}
+
+void TestSafeDartBuilder::testScopeGetScoped()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/@scoped", QStringList { "TestObjectInvokableWithBuilder" });
+    _builder->setConfiguration(configuration);
+
+    QSharedPointer<TestObjectInvokableWithBuilder> parentObject = _builder
+            ->get<TestObjectInvokableWithBuilder>();
+
+    QSharedPointer<Builder> scope = _builder->createScope();
+    QSharedPointer<TestObjectInvokableWithBuilder> scopeObject = scope
+            ->get<TestObjectInvokableWithBuilder>();
+
+    QVERIFY2(scopeObject, "Scope did not create an object");
+    QVERIFY2(scopeObject != parentObject, "Scope used its parent's object");
+    QVERIFY2(scopeObject->builder == scope.data(), "Object was not created with the scope");
+    QVERIFY2(scope->get<TestObjectInvokableWithBuilder>() == scopeObject, "Scope did not reuse its object");
+    QVERIFY2(scope->configuration() == configuration, "Scope did not use its parent's configuration");
+}
+
+void TestSafeDartBuilder::testSealCollidingHashes()
+{
+    _builder->seal(QList<QByteArray>() << "TestObjectInvokableWithNone" << "TestObjectInvokableWithBuilder");
+    SealedTable *sealed = _builder->_sealed.load();
+    InstanceTable::Resolution *none = sealed->find(Atom("TestObjectInvokableWithNone"));
+    InstanceTable::Resolution *withBuilder = sealed->find(Atom("TestObjectInvokableWithBuilder"));
+    QVERIFY2(none && withBuilder, "Sealed table did not find the sealed names");
+
+    // A repeated name has the same full hash as itself, which no displacement
+    // can separate; the table leaves it out rather than growing forever
+    SealedTable table(QVector<InstanceTable::Resolution *> { none, withBuilder, none }, sealed->stamp());
+    QVERIFY2(table.size() == 1, "Sealed table kept names whose hashes collided");
+    QVERIFY2(!table.find(Atom("TestObjectInvokableWithNone")), "Sealed table found a name whose hash collided");
+    QVERIFY2(table.find(Atom("TestObjectInvokableWithBuilder")) == withBuilder, "Sealed table lost a name");
+}
+
+void TestSafeDartBuilder::testSealGet()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    configuration->set("safedart/TestObject", "TestObjectInvokableWithNone");
+    _builder->setConfiguration(configuration);
+
+    QSharedPointer<QObject> first = _builder->get("TestObject");
+    _builder->seal(QList<QByteArray>() << "TestObjectInvokableWithBuilder");
+
+    QVERIFY2(_builder->isSealed(), "Builder was not sealed");
+    QVERIFY2(_builder->createScope()->isSealed(), "Scope did not follow its sealed parent");
+    QVERIFY2(_builder->get("TestObject") == first, "Builder did not use existing object");
+
+    // Sealed names are planned up front, and no longer follow the configuration
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithBuilder"];
+    QVERIFY2(instance._plan.loadAcquire(), "Builder did not plan the construction of a sealed name");
+
+    configuration->set("safedart/TestObject", "TestObjectInvokableWithBuilder");
+    QVERIFY2(_builder->get("TestObject") == first, "Builder followed a configuration change after sealing");
+
+    // Names which were not sealed are still resolved
+    QVERIFY2(_builder->get<TestObjectInvokableWithNone>("TestObjectInvokableWithNone"), "Failed to create object");
+}
+
+void TestSafeDartBuilder::testSealReclaimConcurrent()
+{
+    class ReclaimThread : public QThread
+    {
+    public:
+        ReclaimThread(Builder *builder, QObject *parent = 0) :
+            QThread(parent),
+            builder(builder)
+        {
+        }
+
+        void run() override
+        {
+            while (!stop.loadAcquire())
+                builder->reclaim();
+        }
+
+        Builder *builder;
+        QAtomicInt stop;
+    };
+
+    for (int round = 0; round < 50; round++)
+    {
+        // Names which have been requested but have no object are reclaimable
+        _builder.reset(new OpenBuilder);
+        QList<QByteArray> names;
+        for (int i = 0; i < 64; i++)
+        {
+            names.append(QByteArray("Missing") + QByteArray::number(i));
+            _builder->tryGet(names.last().constData());
+        }
+
+        ReclaimThread thread(_builder.data());
+        thread.start();
+        _builder->seal();
+        thread.stop.storeRelease(1);
+        thread.wait();
+
+        // Every sealed name must still be in the table, or the table refers to
+        // a deleted Instance
+        SealedTable *sealed = _builder->_sealed.loadAcquire();
+        for (const QByteArray &name : names)
+        {
+            InstanceTable::Resolution *resolution = sealed->find(name.constData(), name.size());
+            if (resolution)
+                QVERIFY2(_builder->_instances.find(name) == resolution->requested, "Sealed name was reclaimed");
+        }
+        QVERIFY2(_builder->reclaim() == 0, "Builder reclaimed a name after sealing");
+    }
+}
+
+void TestSafeDartBuilder::testSealRejectsChanges()
+{
+    QSharedPointer<TestObjectInvokableWithNone> existing = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->get("TestObjectInvokableWithBuilder");
+    _builder->seal();
+    _builder->seal();
+
+    QVERIFY_EXCEPTION_THROWN(_builder->provide("TestObjectInvokableWithNone", existing), BuilderException);
+    QVERIFY_EXCEPTION_THROWN(_builder->setConfiguration(QSharedPointer<Configuration>(new MemoryConfiguration)),
+                             BuilderException);
+    QVERIFY2(_builder->reclaim() == 0, "Builder reclaimed a sealed name");
+
+    // Scopes hold objects of their own, so may still be given them
+    QSharedPointer<Builder> scope = _builder->createScope();
+    scope->provide("TestObjectInvokableWithNone", existing);
+    QVERIFY2(scope->get("TestObjectInvokableWithNone") == existing, "Scope did not use provided object");
+}
+
+void TestSafeDartBuilder::testSetConfiguration()
+{
+    QSharedPointer<Configuration> configuration(new MemoryConfiguration);
+    QString section = QUuid::createUuid().toString();
+
+    _builder->setConfiguration(configuration, section);
+
+    QVERIFY2(_builder->_configuration == configuration, "Did not set configuration");
+    QVERIFY2(_builder->_section == section, "Did not set section");
+}
+
+void TestSafeDartBuilder::testTraceNested()
+{
+    Tracer::start();
+    _builder->get("TestObjectRecursive");
+    Tracer::stop();
+
+    // Existing objects are not constructed, so are not traced
+    _builder->get("TestObjectRecursive");
+
+    QJsonArray events = QJsonDocument::fromJson(Tracer::toJson()).object().value("traceEvents").toArray();
+    QStringList sequence;
+    for (const QJsonValue &value : events)
+    {
+        QJsonObject event = value.toObject();
+        sequence.append(event.value("ph").toString() + " " + event.value("name").toString());
+
+        QVERIFY2(event.value("cat").toString() == "builder", "Event has the wrong category");
+        QVERIFY2(event.value("tid") == events.first().toObject().value("tid"), "Event was recorded on the wrong thread");
+    }
+
+    QStringList expected = {
+        "B TestObjectRecursive",
+        "B TestObjectInvokableWithNone",
+        "E TestObjectInvokableWithNone",
+        "E TestObjectRecursive"
+    };
+    QVERIFY2(sequence == expected, "Constructions were not traced as nested spans");
+}
+
+void TestSafeDartBuilder::testTryGetExisting()
+{
+    QSharedPointer<QObject> existing = _builder->get("TestObjectInvokableWithNone");
+
+    GetResult<TestObjectInvokableWithNone> result = _builder->tryGet<TestObjectInvokableWithNone>();
+    QVERIFY2(result, "Builder did not get the object");
+    QVERIFY2(result.error() == Builder::NoError, "Builder reported an error");
+    QVERIFY2(result.object() == existing, "Builder did not use the existing object");
+}
+
+void TestSafeDartBuilder::testTryGetMissing()
+{
+    GetResult<QObject> result = _builder->tryGet("TestObjectNonexistent");
+    QVERIFY2(!result, "Builder got a nonexistent object");
+    QVERIFY2(result.error() == Builder::NotFoundError, "Builder reported the wrong error");
+    QVERIFY2(result.errorString().contains("TestObjectNonexistent"), "Builder did not describe the error");
+
+    // The missing name is remembered until more types may have been added
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectNonexistent"];
+    QVERIFY2(instance._missing.loadAcquire() == FactoryRegistry::revision() + 1, "Builder did not remember the missing name");
+
+    FactoryRegistry::typesAdded();
+    QVERIFY2(instance._missing.loadAcquire() != FactoryRegistry::revision() + 1, "Builder did not forget the missing name");
+    QVERIFY2(_builder->tryGet("TestObjectNonexistent").error() == Builder::NotFoundError, "Builder reported the wrong error");
+    QVERIFY_EXCEPTION_THROWN(_builder->get("TestObjectNonexistent"), BuilderException);
+}
+
+void TestSafeDartBuilder::testTryGetNotInvokable()
+{
+    GetResult<QObject> result = _builder->tryGet("TestObjectNotInvokable");
+    QVERIFY2(!result, "Builder created an object without an invokable constructor");
+    QVERIFY2(result.error() == Builder::NotCreatedError, "Builder reported the wrong error");
+}
+
+void TestSafeDartBuilder::testTryGetUsesPlan()
+{
+    // Let the object expire, leaving only its construction plan
+    QVERIFY2(_builder->tryGet("TestObjectInvokableWithNone"), "Failed to create object");
+    OpenBuilder::Instance &instance = _builder->_instances["TestObjectInvokableWithNone"];
+    QVERIFY2(instance._reference.isNull() && instance._plan.loadAcquire(), "Object did not expire");
+
+    // Had the type been looked for again, it would have seemed to be missing
+    instance._missing.storeRelease(FactoryRegistry::revision() + 1);
+    QVERIFY2(_builder->tryGet("TestObjectInvokableWithNone"), "Builder looked for a type it had already planned");
+}
+
+void TestSafeDartBuilder::testTryGetWrongType()
+{
+    GetResult<TestObjectInvokableWithNone> result = _builder
+            ->tryGet<TestObjectInvokableWithNone>("TestObjectInvokableWithBuilder");
+    QVERIFY2(!result, "Builder returned an object of the wrong type");
+    QVERIFY2(result.error() == Builder::WrongTypeError, "Builder reported the wrong error");
+    QVERIFY2(!result.object(), "Builder returned an object of the wrong type");
+}
+
+void TestSafeDartBuilder::benchmarkFactoryCreate()
+{
+    Factory<TestObjectReflectable> factory = _builder->factory<TestObjectReflectable>("TestObjectReflectable");
 
     QBENCHMARK
     {
-        _builder->get("TestObjectInvokableWithNone");
+        factory.create();
+    }
+}
+
+void TestSafeDartBuilder::benchmarkGetAllExisting_data()
+{
+    QTest::addColumn<int>("count");
+
+    for (int count = 1; count <= 64; count *= 4)
+        QTest::newRow(qPrintable(QString("%1 name(s)").arg(count))) << count;
+}
+
+void TestSafeDartBuilder::benchmarkGetAllExisting()
+{
+    QFETCH(int, count);
+
+    QSharedPointer<TestObjectInvokableWithNone> existing = QSharedPointer<TestObjectInvokableWithNone>::create();
+    QList<QByteArray> names;
+    for (int i = 0; i < count; i++)
+    {
+        names.append(QByteArray("Existing") + QByteArray::number(i));
+        _builder->provide(names.last().constData(), existing);
+    }
+
+    QBENCHMARK
+    {
+        _builder->getAll(names);
+    }
+}
+
+void TestSafeDartBuilder::benchmarkGetAtomExisting()
+{
+    QSharedPointer<TestObjectInvokableWithNone> existing = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->provide("TestObjectInvokableWithNone", existing);
+
+    // Compare with the first row of benchmarkGetExisting
+    Atom name("TestObjectInvokableWithNone");
+    QBENCHMARK
+    {
+        _builder->get(name);
+    }
+}
+
+void TestSafeDartBuilder::benchmarkGetExisting_data()
+{
+    QTest::addColumn<int>("threads");
+
+    for (int threads = 1; threads <= 64; threads *= 2)
+        QTest::newRow(qPrintable(QString("%1 thread(s)").arg(threads))) << threads;
+}
+
+void TestSafeDartBuilder::benchmarkGetExisting()
+{
+    QFETCH(int, threads);
+
+    QSharedPointer<TestObjectInvokableWithNone> existing = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->provide("TestObjectInvokableWithNone", existing);
+
+    // Every thread performs the same number of gets, so the time per iteration
+    // stays flat for as long as gets scale with the number of threads
+    QBENCHMARK
+    {
+        QList<GetThread *> getThreads;
+        for (int i = 0; i < threads; i++)
+            getThreads.append(new GetThread(_builder.data(), "TestObjectInvokableWithNone", 10000));
+
+        for (GetThread *thread : getThreads)
+            thread->start();
+        for (GetThread *thread : getThreads)
+            thread->wait();
+
+        qDeleteAll(getThreads);
+    }
+}
+
+void TestSafeDartBuilder::benchmarkGetExistingSealed_data()
+{
+    benchmarkGetExisting_data();
+}
+
+void TestSafeDartBuilder::benchmarkGetExistingSealed()
+{
+    QFETCH(int, threads);
+
+    QSharedPointer<TestObjectInvokableWithNone> existing = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->provide("TestObjectInvokableWithNone", existing);
+    _builder->seal();
+
+    // The same work as benchmarkGetExisting, without locking to look the name up
+    QBENCHMARK
+    {
+        QList<GetThread *> getThreads;
+        for (int i = 0; i < threads; i++)
+            getThreads.append(new GetThread(_builder.data(), "TestObjectInvokableWithNone", 10000));
+
+        for (GetThread *thread : getThreads)
+            thread->start();
+        for (GetThread *thread : getThreads)
+            thread->wait();
+
+        qDeleteAll(getThreads);
     }
 }
 
@@ -378,6 +2009,138 @@ void TestSafeDartBuilder::benchmarkGetNew()
     }
 }
 
+void TestSafeDartBuilder::benchmarkGetNewReflectable()
+{
+    QBENCHMARK
+    {
+        _builder->get("TestObjectReflectable");
+    }
+}
+
+void TestSafeDartBuilder::benchmarkGetTypedExisting_data()
+{
+    QTest::addColumn<bool>("typed");
+
+    QTest::newRow("untyped") << false;
+    QTest::newRow("typed") << true;
+}
+
+void TestSafeDartBuilder::benchmarkGetTypedExisting()
+{
+    QFETCH(bool, typed);
+
+    QSharedPointer<TestObjectImplementing> existing = QSharedPointer<TestObjectImplementing>::create();
+    _builder->provide("TestInterface", existing);
+
+    // The difference between the rows is the cost of casting to the interface
+    if (typed)
+    {
+        QBENCHMARK
+        {
+            _builder->get<TestInterface>();
+        }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            _builder->get("TestInterface");
+        }
+    }
+}
+
+void TestSafeDartBuilder::benchmarkGetSeveralExisting_data()
+{
+    benchmarkGetAllExisting_data();
+}
+
+void TestSafeDartBuilder::benchmarkGetSeveralExisting()
+{
+    QFETCH(int, count);
+
+    QSharedPointer<TestObjectInvokableWithNone> existing = QSharedPointer<TestObjectInvokableWithNone>::create();
+    QList<QByteArray> names;
+    for (int i = 0; i < count; i++)
+    {
+        names.append(QByteArray("Existing") + QByteArray::number(i));
+        _builder->provide(names.last().constData(), existing);
+    }
+
+    // The same work as benchmarkGetAllExisting, one get at a time
+    QBENCHMARK
+    {
+        for (const QByteArray &name : names)
+            _builder->get(name.constData());
+    }
+}
+
+void TestSafeDartBuilder::benchmarkHandleGetExisting()
+{
+    QSharedPointer<TestObjectInvokableWithNone> existing = QSharedPointer<TestObjectInvokableWithNone>::create();
+    _builder->provide("TestObjectInvokableWithNone", existing);
+
+    ServiceHandle<TestObjectInvokableWithNone> handle = _builder->handle<TestObjectInvokableWithNone>();
+
+    QBENCHMARK
+    {
+        handle.get();
+    }
+}
+
+void TestSafeDartBuilder::benchmarkInstanceTableAdd_data()
+{
+    QTest::addColumn<int>("count");
+
+    for (int count = 10000; count <= 1000000; count *= 10)
+        QTest::newRow(qPrintable(QString("%1 name(s)").arg(count))) << count;
+}
+
+void TestSafeDartBuilder::benchmarkInstanceTableAdd()
+{
+    QFETCH(int, count);
+
+    QList<QByteArray> names;
+    for (int i = 0; i < count; i++)
+        names.append(QByteArray("Device") + QByteArray::number(i));
+
+    // Includes every resize along the way
+    QBENCHMARK
+    {
+        InstanceTable table;
+        for (const QByteArray &name : names)
+            table[name];
+    }
+}
+
+void TestSafeDartBuilder::benchmarkInstanceTableFind_data()
+{
+    benchmarkInstanceTableAdd_data();
+}
+
+void TestSafeDartBuilder::benchmarkInstanceTableFind()
+{
+    QFETCH(int, count);
+
+    InstanceTable table;
+    QList<QByteArray> names;
+    for (int i = 0; i < count; i++)
+    {
+        names.append(QByteArray("Device") + QByteArray::number(i));
+        table[names.last()];
+    }
+
+    // Look up names spread across the whole table, so that few are cached
+    QList<QByteArray> sample;
+    for (int i = 0; i < 1000; i++)
+        sample.append(names.at(int(quint64(i) * 7919 % quint64(count))));
+
+    QBENCHMARK
+    {
+        for (const QByteArray &name : sample)
+            table.find(name);
+    }
+}
+
 void TestSafeDartBuilder::benchmarkProvide()
 {
     QSharedPointer<TestObjectInvokableWithNone> existing = QSharedPointer<TestObjectInvokableWithNone>::create();
@@ -388,6 +2151,14 @@ void TestSafeDartBuilder::benchmarkProvide()
     }
 }
 
+void TestSafeDartBuilder::benchmarkTryGetMissing()
+{
+    QBENCHMARK
+    {
+        _builder->tryGet("TestObjectNonexistent");
+    }
+}
+
 QTEST_GUILESS_MAIN(TestSafeDartBuilder)
 
 #include "tst_testsafedartbuilder.moc"
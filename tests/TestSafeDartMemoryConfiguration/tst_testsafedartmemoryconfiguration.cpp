@@ -69,6 +69,7 @@ private slots:
 
     void testClear();
     void testGetAbsent();
+    void testGetAtom();
     void testGetPresent();
     void testRemoveAbsent();
     void testRemovePresent();
@@ -157,6 +158,14 @@ void TestSafeDartMemoryConfiguration::testGetAbsent()
     QVERIFY2(result == "default", "MemoryConfiguration did not return default value.");
 }
 
+void TestSafeDartMemoryConfiguration::testGetAtom()
+{
+    OpenMemoryConfiguration configuration(sampleData());
+
+    QVERIFY2(configuration.get(Atom("d"), "default") == "foo", "MemoryConfiguration did not return assigned value.");
+    QVERIFY2(configuration.get(Atom("e"), "default") == "default", "MemoryConfiguration did not return default value.");
+}
+
 void TestSafeDartMemoryConfiguration::testGetPresent()
 {
     OpenMemoryConfiguration configuration(sampleData());